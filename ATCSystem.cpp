@@ -1,60 +1,76 @@
 #include "ATCSystem.h"
+#include "Snapshot.h"
 #include "Utilities.h"
 #include "Exceptions.h"
 #include "Colors.h"
+#include "Metrics.h"
 #include <iostream>
 #include <cstring>
 #include <cstdio>
+#include <climits>
 #include <limits>
 
 using namespace std;
 
-void ATCSystem::initializeAirspace() {
+// The built-in 12-node demo airspace used when no airspace file is given.
+void ATCSystem::loadDefaultAirspace() {
+    graph.addNode("JFK", 2, 2, true);
+    graph.addNode("LHR", 17, 3, true);
+    graph.addNode("DXB", 10, 17, true);
+    graph.addNode("ISB", 15, 10, true);
+
+    graph.addNode("WP1", 5, 5, false);
+    graph.addNode("WP2", 10, 5, false);
+    graph.addNode("WP3", 15, 5, false);
+    graph.addNode("WP4", 5, 10, false);
+    graph.addNode("WP5", 10, 10, false);
+    graph.addNode("WP6", 5, 15, false);
+    graph.addNode("WP7", 10, 15, false);
+    graph.addNode("WP8", 15, 15, false);
+
+    graph.addEdge(0, 4, 50);
+    graph.addEdge(4, 0, 50);
+    graph.addEdge(4, 5, 40);
+    graph.addEdge(5, 4, 40);
+    graph.addEdge(4, 7, 45);
+    graph.addEdge(7, 4, 45);
+    graph.addEdge(5, 6, 35);
+    graph.addEdge(6, 5, 35);
+    graph.addEdge(5, 8, 40);
+    graph.addEdge(8, 5, 40);
+    graph.addEdge(6, 1, 30);
+    graph.addEdge(1, 6, 30);
+    graph.addEdge(6, 3, 45); 
+    graph.addEdge(3, 6, 45);
+    graph.addEdge(7, 8, 40);
+    graph.addEdge(8, 7, 40);
+    graph.addEdge(7, 9, 35); 
+    graph.addEdge(9, 7, 35);
+    graph.addEdge(8, 10, 40);
+    graph.addEdge(10, 8, 40);
+    graph.addEdge(8, 3, 50);
+    graph.addEdge(3, 8, 50);
+    graph.addEdge(9, 10, 35);
+    graph.addEdge(10, 9, 35);
+    graph.addEdge(10, 2, 30);
+    graph.addEdge(2, 10, 30);
+    graph.addEdge(10, 11, 35);
+    graph.addEdge(11, 10, 35);
+    graph.addEdge(11, 3, 40);
+    graph.addEdge(3, 11, 40);
+}
+
+void ATCSystem::initializeAirspace(const char* airspaceFile) {
     try {
-        graph.addNode("JFK", 2, 2, true);
-        graph.addNode("LHR", 17, 3, true);
-        graph.addNode("DXB", 10, 17, true);
-        graph.addNode("ISB", 15, 10, true);
-
-        graph.addNode("WP1", 5, 5, false);
-        graph.addNode("WP2", 10, 5, false);
-        graph.addNode("WP3", 15, 5, false);
-        graph.addNode("WP4", 5, 10, false);
-        graph.addNode("WP5", 10, 10, false);
-        graph.addNode("WP6", 5, 15, false);
-        graph.addNode("WP7", 10, 15, false);
-        graph.addNode("WP8", 15, 15, false);
-
-        graph.addEdge(0, 4, 50);
-        graph.addEdge(4, 0, 50);
-        graph.addEdge(4, 5, 40);
-        graph.addEdge(5, 4, 40);
-        graph.addEdge(4, 7, 45);
-        graph.addEdge(7, 4, 45);
-        graph.addEdge(5, 6, 35);
-        graph.addEdge(6, 5, 35);
-        graph.addEdge(5, 8, 40);
-        graph.addEdge(8, 5, 40);
-        graph.addEdge(6, 1, 30);
-        graph.addEdge(1, 6, 30);
-        graph.addEdge(6, 3, 45); 
-        graph.addEdge(3, 6, 45);
-        graph.addEdge(7, 8, 40);
-        graph.addEdge(8, 7, 40);
-        graph.addEdge(7, 9, 35); 
-        graph.addEdge(9, 7, 35);
-        graph.addEdge(8, 10, 40);
-        graph.addEdge(10, 8, 40);
-        graph.addEdge(8, 3, 50);
-        graph.addEdge(3, 8, 50);
-        graph.addEdge(9, 10, 35);
-        graph.addEdge(10, 9, 35);
-        graph.addEdge(10, 2, 30);
-        graph.addEdge(2, 10, 30);
-        graph.addEdge(10, 11, 35);
-        graph.addEdge(11, 10, 35);
-        graph.addEdge(11, 3, 40);
-        graph.addEdge(3, 11, 40);
+        if (airspaceFile != nullptr) {
+            graph.loadFromFile(airspaceFile);
+        }
+        else {
+            loadDefaultAirspace();
+        }
+
+        graph.buildCSR();
+        graph.buildNearestAirportTable();
 
         radar.initialize(graph);
     }
@@ -66,11 +82,10 @@ void ATCSystem::initializeAirspace() {
 
 void ATCSystem::displayRadar() {
     try {
-        Aircraft flights[MAX_FLIGHTS];
-        int count;
-        registry.getAllFlights(flights, count);
+        DynamicArray<Aircraft> flights;
+        registry.getAllFlights(flights);
         radar.initialize(graph);
-        radar.placePlanes(flights, count);
+        radar.placePlanes(flights);
         radar.display();
     }
     catch (const ATCException& e) {
@@ -78,23 +93,359 @@ void ATCSystem::displayRadar() {
     }
 }
 
+void ATCSystem::displaySeparationAlerts() {
+    conflictDetector.rebuild(registry, MIN_SEPARATION);
+    DynamicArray<ConflictPair> pairs;
+    conflictDetector.findConflicts(MIN_SEPARATION, pairs);
+
+    if (pairs.isEmpty()) {
+        setColor(10);
+        cout << "  No separation conflicts." << endl;
+        setColor(15);
+        return;
+    }
+
+    for (int i = 0; i < pairs.getSize() && i < 10; i++) {
+        const AircraftStore& store = registry.getStore();
+        int a = pairs[i].first;
+        int b = pairs[i].second;
+        setColor(12);
+        cout << "  [CONFLICT] ";
+        setColor(11);
+        cout << store.flightID(a);
+        setColor(15);
+        cout << " (" << store.gridX(a) << ", " << store.gridY(a) << ") <-> ";
+        setColor(11);
+        cout << store.flightID(b);
+        setColor(15);
+        cout << " (" << store.gridX(b) << ", " << store.gridY(b) << ")" << endl;
+    }
+    if (pairs.getSize() > 10) {
+        setColor(14);
+        cout << "  ... and " << pairs.getSize() - 10 << " more" << endl;
+        setColor(15);
+    }
+}
+
 void ATCSystem::checkCollision(int x, int y, const char* excludeFlightID) {
-    Aircraft existingFlights[MAX_FLIGHTS];
-    int count;
-    registry.getAllFlights(existingFlights, count);
+    int exclude = excludeFlightID != nullptr ? registry.findHandle(excludeFlightID) : -1;
+    int occupant = registry.findOccupant(x, y, exclude);
+    if (occupant != -1) {
+        METRIC_COUNT(CTR_COLLISIONS);
+        throw CollisionException(fleet.flightID(occupant));
+    }
+}
+
+ATCSystem::ATCSystem(const char* airspaceFile)
+    : registry(fleet), landingQueue(registry), flightLog(fleet),
+      simulation(graph, registry, landingQueue, flightLog),
+      journal("journal.txt"), snapshotGeneration(0) {
+    initializeAirspace(airspaceFile);
+}
+
+int ATCSystem::spawnFlight(Aircraft flight, int nodeID) {
+    METRIC_TIMER(OP_ADD_FLIGHT);
+    if (strlen(flight.flightID) == 0) {
+        throw InvalidFlightDataException("Flight ID cannot be empty");
+    }
+    if (registry.exists(flight.flightID)) {
+        METRIC_COUNT(CTR_DUPLICATE_FLIGHTS);
+        throw DuplicateFlightException(flight.flightID);
+    }
+    if (flight.fuelLevel < 0 || flight.fuelLevel > 100) {
+        throw OutOfRangeException("Fuel level (must be 0-100)");
+    }
+    if (flight.priority < 1 || flight.priority > 4) {
+        throw OutOfRangeException("Priority (must be 1-4)");
+    }
+    if (!graph.isValidNode(nodeID)) {
+        throw InvalidNodeException(nodeID);
+    }
+
+    if (flight.fuelLevel < 10 && flight.priority > 2) {
+        flight.priority = 2;
+    }
 
-    for (int i = 0; i < count; i++) {
-        if (excludeFlightID != nullptr && strcmp(existingFlights[i].flightID, excludeFlightID) == 0) {
+    flight.graphNode = nodeID;
+    flight.gridX = graph.getNodeX(nodeID);
+    flight.gridY = graph.getNodeY(nodeID);
+
+    checkCollision(flight.gridX, flight.gridY);
+
+    flight.inAir = true;
+    flight.timestamp = getCurrentTimestamp();
+
+    int handle = registry.insert(flight);
+    landingQueue.insert(handle);
+    journal.recordAdd(flight);
+    METRIC_COUNT(CTR_FLIGHTS_ADDED);
+    return handle;
+}
+
+// Returns true when the fuel burn triggered a low-fuel priority upgrade.
+bool ATCSystem::relocateFlight(const char* flightID, int destNode) {
+    METRIC_TIMER(OP_MOVE_FLIGHT);
+    int handle = registry.findHandle(flightID);
+    if (handle == -1) {
+        throw FlightNotFoundException(flightID);
+    }
+    if (!fleet.inAir(handle)) {
+        throw InvalidFlightDataException("Flight is not in air");
+    }
+    if (!graph.isValidNode(destNode)) {
+        throw InvalidNodeException(destNode);
+    }
+
+    int newX = graph.getNodeX(destNode);
+    int newY = graph.getNodeY(destNode);
+
+    checkCollision(newX, newY, flightID);
+
+    registry.updatePosition(handle, destNode, newX, newY);
+    int& fuel = fleet.fuelLevel(handle);
+    fuel -= 5;
+    if (fuel < 0) fuel = 0;
+
+    bool upgraded = false;
+    if (fuel < 10 && fleet.priority(handle) > 2) {
+        fleet.priority(handle) = 2;
+        upgraded = true;
+        METRIC_COUNT(CTR_LOW_FUEL_UPGRADES);
+    }
+    landingQueue.refresh(flightID);
+    journal.recordMove(flightID, destNode, newX, newY, fuel, fleet.priority(handle));
+    return upgraded;
+}
+
+// Emergency types 1-3 (medical, engine, hijack) become CRITICAL, 4 (low
+// fuel) becomes HIGH. Returns false when the flight already had that
+// priority or better.
+bool ATCSystem::applyEmergency(const char* flightID, int emergencyType) {
+    METRIC_TIMER(OP_DECLARE_EMERGENCY);
+    if (!registry.exists(flightID)) {
+        throw FlightNotFoundException(flightID);
+    }
+    if (emergencyType < 1 || emergencyType > 4) {
+        throw InvalidInputException("Invalid emergency type");
+    }
+
+    int newPriority = (emergencyType <= 3) ? 1 : 2;
+    if (!landingQueue.decreaseKey(flightID, newPriority)) {
+        return false;
+    }
+    journal.recordPriority(flightID, newPriority);
+    return true;
+}
+
+Aircraft ATCSystem::landNextFlight() {
+    METRIC_TIMER(OP_LAND_FLIGHT);
+    int handle = landingQueue.extractMinHandle();
+    registry.markLanded(handle);
+
+    int now = getCurrentTimestamp();
+    flightLog.insert(handle, now, "LANDED");
+    journal.recordLanding(fleet.flightID(handle), now);
+    METRIC_COUNT(CTR_FLIGHTS_LANDED);
+
+    Aircraft landed = registry.get(handle);
+    landed.timestamp = now;
+    return landed;
+}
+
+int ATCSystem::routeToSafety(const char* flightID, DynamicArray<int>& path) {
+    METRIC_TIMER(OP_FIND_SAFE_ROUTE);
+    int handle = registry.findHandle(flightID);
+    if (handle == -1) {
+        throw FlightNotFoundException(flightID);
+    }
+
+    int nearestAirport = graph.findNearestAirport(fleet.graphNode(handle), path);
+    if (nearestAirport == -1) {
+        throw NoRouteException();
+    }
+    return nearestAirport;
+}
+
+bool ATCSystem::findFlight(const char* flightID, Aircraft& flight) const {
+    return registry.search(flightID, flight);
+}
+
+const Graph& ATCSystem::getGraph() const {
+    return graph;
+}
+
+const FlightLog& ATCSystem::getFlightLog() const {
+    return flightLog;
+}
+
+// Rewrites the snapshot and empties the journal. The snapshot goes first
+// and carries a new generation, different from the one in the journal on
+// disk. If the truncation then fails, the old journal no longer matches and
+// is not replayed on load: its records may predate ticks the snapshot
+// already includes, and replaying them would move flights back. A journal
+// whose GEN line cannot be read counts as generation 0, so the snapshot
+// still goes ahead and the reset replaces the damaged journal.
+void ATCSystem::writeSnapshot() {
+    unsigned int onDisk = 0;
+    try {
+        onDisk = journal.readGeneration();
+    }
+    catch (const ParseException&) {
+        onDisk = 0;
+    }
+    unsigned int generation = (snapshotGeneration > onDisk ? snapshotGeneration : onDisk) + 1;
+    if (generation > INT_MAX) generation = 1;
+    saveSnapshot("state.bin", registry, flightLog, generation);
+    snapshotGeneration = generation;
+    journal.reset(generation);
+    METRIC_COUNT(CTR_SNAPSHOTS);
+}
+
+// A save appends the records since the last save to the journal, so its
+// cost follows the number of changes. A full snapshot is written instead
+// when the files on disk do not describe this session's state, or when the
+// journal has grown past the larger of JOURNAL_MIN_COMPACT_RECORDS and
+// the number of live records, which keeps compaction amortized.
+void ATCSystem::writeState() {
+    METRIC_TIMER(OP_SAVE_STATE);
+    int journalLength = journal.getCommittedCount() + journal.getPendingCount();
+    int compactAt = fleet.getLiveCount() > JOURNAL_MIN_COMPACT_RECORDS
+        ? fleet.getLiveCount() : JOURNAL_MIN_COMPACT_RECORDS;
+
+    if (!journal.isRecording() || journalLength > compactAt) {
+        writeSnapshot();
+        return;
+    }
+    METRIC_ADD(CTR_JOURNAL_RECORDS, journal.getPendingCount());
+    journal.commit();
+}
+
+void ATCSystem::readState() {
+    METRIC_TIMER(OP_LOAD_STATE);
+    bool wasEmpty = registry.getCount() == 0 && flightLog.isEmpty();
+
+    // Without a binary snapshot (e.g. generated test data, or state saved
+    // by an older build) the text files are imported instead.
+    unsigned int generation = 0;
+    bool fromSnapshot = loadSnapshot("state.bin", registry, flightLog, &generation);
+    if (!fromSnapshot) {
+        registry.loadFromFile("flights.txt");
+        flightLog.loadFromFile("flightlog.txt");
+    }
+
+    if (fromSnapshot && generation > snapshotGeneration) {
+        snapshotGeneration = generation;
+    }
+
+    // The journal holds changes on top of one snapshot. It is replayed only
+    // over that snapshot: one from another generation is stale (see
+    // writeSnapshot), and the text files are not a snapshot at all. A
+    // corrupt journal still leaves the loaded flights queued, and the next
+    // save writes a full snapshot.
+    DynamicArray<JournalRecord> records;
+    unsigned int journalGeneration = 0;
+    bool current;
+    try {
+        bool hasJournal = journal.readRecords(records, journalGeneration);
+        current = fromSnapshot && (!hasJournal || journalGeneration == generation);
+        if (current) {
+            replayJournal(records);
+        }
+    }
+    catch (...) {
+        queueAirborneFlights();
+        journal.suspend();
+        throw;
+    }
+    queueAirborneFlights();
+
+    // Loading a snapshot and its own journal into an empty system reproduces
+    // the saved state exactly, so later saves can keep appending to it.
+    if (wasEmpty && fromSnapshot && current) {
+        journal.discardPending();
+        journal.resume(generation);
+    }
+    else {
+        journal.suspend();
+    }
+}
+
+// Loaded flights still in the air need a landing slot too. Replayed moves
+// may have changed flights that were already queued.
+void ATCSystem::queueAirborneFlights() {
+    for (int h = 0; h < fleet.getHandleLimit(); h++) {
+        if (fleet.inAir(h) && !landingQueue.contains(h)) {
+            landingQueue.insert(h);
+        }
+    }
+    landingQueue.rekeyAll();
+}
+
+// Pipe-delimited text copies of the registry and the flight log, for
+// inspection or for other tools. Not part of the snapshot/journal chain.
+void ATCSystem::exportText(const char* flightsFile, const char* logFile) {
+    METRIC_TIMER(OP_SAVE_STATE);
+    registry.saveToFile(flightsFile);
+    flightLog.saveToFile(logFile);
+}
+
+// Merges text files into the current state. The result no longer matches
+// the snapshot on disk, so the next save writes a new one.
+void ATCSystem::importText(const char* flightsFile, const char* logFile) {
+    METRIC_TIMER(OP_LOAD_STATE);
+    registry.loadFromFile(flightsFile);
+    flightLog.loadFromFile(logFile);
+    queueAirborneFlights();
+    journal.suspend();
+}
+
+// Applies journal records on top of the loaded snapshot. Records already
+// reflected in the snapshot are skipped or rewrite the same values.
+void ATCSystem::replayJournal(const DynamicArray<JournalRecord>& records) {
+    for (int i = 0; i < records.getSize(); i++) {
+        const Aircraft& a = records[i].aircraft;
+        if (records[i].type == JOURNAL_ADD) {
+            if (!registry.exists(a.flightID)) {
+                registry.insert(a);
+            }
             continue;
         }
-        if (existingFlights[i].gridX == x && existingFlights[i].gridY == y) {
-            throw CollisionException(existingFlights[i].flightID);
+
+        int handle = registry.findHandle(a.flightID);
+        if (handle == -1) continue;
+
+        switch (records[i].type) {
+        case JOURNAL_MOVE:
+            registry.updatePosition(handle, a.graphNode, a.gridX, a.gridY);
+            fleet.fuelLevel(handle) = a.fuelLevel;
+            fleet.priority(handle) = a.priority;
+            break;
+        case JOURNAL_PRIORITY:
+            fleet.priority(handle) = a.priority;
+            break;
+        case JOURNAL_LAND:
+            if (fleet.inAir(handle)) {
+                registry.markLanded(handle);
+                landingQueue.removeHandle(handle);
+                flightLog.insert(handle, a.timestamp, "LANDED");
+            }
+            break;
         }
     }
 }
 
-ATCSystem::ATCSystem() {
-    initializeAirspace();
+// Ticks update every airborne aircraft and are not journaled, so the next
+// save after one that moved anything writes a snapshot.
+TickStats ATCSystem::runSimulationTick() {
+    TickStats stats = simulation.tick();
+    if (stats.airborne > 0) {
+        journal.suspend();
+    }
+    return stats;
+}
+
+void ATCSystem::setSimulationThreads(int threadCount) {
+    simulation.setThreadCount(threadCount);
 }
 
 void ATCSystem::showAirspaceVisualizer() {
@@ -104,6 +455,14 @@ void ATCSystem::showAirspaceVisualizer() {
     try {
         displayRadar();
 
+        cout << "\n";
+        printLine('-');
+        setColor(14);
+        cout << "  SEPARATION ALERTS (within " << MIN_SEPARATION << " cells):" << endl;
+        setColor(15);
+        printLine('-');
+        displaySeparationAlerts();
+
         cout << "\n";
         printLine('-');
         setColor(14); 
@@ -241,23 +600,13 @@ void ATCSystem::addFlight() {
             throw InvalidNodeException(nodeID);
         }
         setColor(15);
-        newFlight.graphNode = nodeID;
-
-        newFlight.gridX = graph.getNodeX(newFlight.graphNode);
-        newFlight.gridY = graph.getNodeY(newFlight.graphNode);
 
-        checkCollision(newFlight.gridX, newFlight.gridY);
-
-        newFlight.inAir = true;
-        newFlight.timestamp = getCurrentTimestamp();
-
-        registry.insert(newFlight);
-        landingQueue.insert(newFlight);
+        Aircraft added = registry.get(spawnFlight(newFlight, nodeID));
 
         setColor(10); 
         cout << "\n  ========================================" << endl;
-        cout << "  FLIGHT " << newFlight.flightID << " ADDED SUCCESSFULLY!" << endl;
-        cout << "  Position: (" << newFlight.gridX << ", " << newFlight.gridY << ")" << endl;
+        cout << "  FLIGHT " << added.flightID << " ADDED SUCCESSFULLY!" << endl;
+        cout << "  Position: (" << added.gridX << ", " << added.gridY << ")" << endl;
         cout << "  ========================================" << endl;
         setColor(15);
     }
@@ -285,14 +634,14 @@ void ATCSystem::declareEmergency() {
         }
         setColor(15);
 
-        Aircraft* flight = registry.search(flightID);
-        if (!flight) {
+        Aircraft flight;
+        if (!registry.search(flightID, flight)) {
             throw FlightNotFoundException(flightID);
         }
 
         cout << "\n  Current Priority: ";
         setColor(14);
-        cout << flight->priority << endl;
+        cout << flight.priority << endl;
         setColor(15);
 
         setColor(14);
@@ -313,8 +662,7 @@ void ATCSystem::declareEmergency() {
 
         int newPriority = (emergency <= 3) ? 1 : 2;
 
-        if (landingQueue.decreaseKey(flightID, newPriority)) {
-            flight->priority = newPriority;
+        if (applyEmergency(flightID, emergency)) {
             setColor(12);
             cout << "\n  ========================================" << endl;
             cout << "  [EMERGENCY DECLARED]" << endl;
@@ -355,15 +703,7 @@ void ATCSystem::landFlight() {
         setColor(15);
 
         if (choice == 'y' || choice == 'Y') {
-            Aircraft landed = landingQueue.extractMin();
-
-            Aircraft* inRegistry = registry.search(landed.flightID);
-            if (inRegistry) {
-                inRegistry->inAir = false;
-            }
-
-            landed.timestamp = getCurrentTimestamp();
-            flightLog.insert(landed, "LANDED");
+            Aircraft landed = landNextFlight();
 
             setColor(10);
             cout << "\n  ========================================" << endl;
@@ -407,15 +747,14 @@ void ATCSystem::searchFlight() {
         }
         setColor(15);
 
-        Aircraft* flight = registry.search(flightID);
-
-        if (!flight) {
+        Aircraft flight;
+        if (!registry.search(flightID, flight)) {
             throw FlightNotFoundException(flightID);
         }
 
         const char* status;
         int statusColor;
-        switch (flight->priority) {
+        switch (flight.priority) {
         case 1: status = "CRITICAL"; statusColor = 12; break;
         case 2: status = "HIGH"; statusColor = 14; break;
         case 3: status = "MEDIUM"; statusColor = 10; break;
@@ -427,19 +766,19 @@ void ATCSystem::searchFlight() {
         cout << "           FLIGHT INFORMATION" << endl;
         cout << "  ========================================" << endl;
         setColor(15);
-        cout << "  Flight ID:    "; setColor(14); cout << flight->flightID << endl;
-        setColor(15); cout << "  Model:        "; setColor(11); cout << flight->model << endl;
+        cout << "  Flight ID:    "; setColor(14); cout << flight.flightID << endl;
+        setColor(15); cout << "  Model:        "; setColor(11); cout << flight.model << endl;
         setColor(15); cout << "  Fuel Level:   ";
-        if (flight->fuelLevel < 20) setColor(12);
-        else if (flight->fuelLevel < 50) setColor(14);
+        if (flight.fuelLevel < 20) setColor(12);
+        else if (flight.fuelLevel < 50) setColor(14);
         else setColor(10);
-        cout << flight->fuelLevel << "%" << endl;
-        setColor(15); cout << "  Origin:       "; setColor(10); cout << flight->origin << endl;
-        setColor(15); cout << "  Destination:  "; setColor(10); cout << flight->destination << endl;
-        setColor(15); cout << "  Priority:     "; setColor(statusColor); cout << status << " (" << flight->priority << ")" << endl;
-        setColor(15); cout << "  Position:     "; setColor(13); cout << "(" << flight->gridX << ", " << flight->gridY << ")" << endl;
+        cout << flight.fuelLevel << "%" << endl;
+        setColor(15); cout << "  Origin:       "; setColor(10); cout << flight.origin << endl;
+        setColor(15); cout << "  Destination:  "; setColor(10); cout << flight.destination << endl;
+        setColor(15); cout << "  Priority:     "; setColor(statusColor); cout << status << " (" << flight.priority << ")" << endl;
+        setColor(15); cout << "  Position:     "; setColor(13); cout << "(" << flight.gridX << ", " << flight.gridY << ")" << endl;
         setColor(15); cout << "  Status:       ";
-        if (flight->inAir) { setColor(10); cout << "IN AIR"; }
+        if (flight.inAir) { setColor(10); cout << "IN AIR"; }
         else { setColor(14); cout << "LANDED"; }
         cout << endl;
         setColor(11);
@@ -481,18 +820,10 @@ void ATCSystem::findSafeRoute() {
         }
         setColor(15);
 
-        Aircraft* flight = registry.search(flightID);
-        if (!flight) {
-            throw FlightNotFoundException(flightID);
-        }
-
-        int path[MAX_NODES];
-        int pathLen;
-        int nearestAirport = graph.findNearestAirport(flight->graphNode, path, pathLen);
-
-        if (nearestAirport == -1) {
-            throw NoRouteException();
-        }
+        DynamicArray<int> path;
+        int nearestAirport = routeToSafety(flightID, path);
+        Aircraft flight;
+        registry.search(flightID, flight);
 
         setColor(10);
         cout << "\n  ========================================" << endl;
@@ -501,7 +832,7 @@ void ATCSystem::findSafeRoute() {
         setColor(15);
         cout << "  Current Location: ";
         setColor(14);
-        cout << graph.getNodeName(flight->graphNode) << endl;
+        cout << graph.getNodeName(flight.graphNode) << endl;
         setColor(15);
         cout << "  Nearest Airport:  ";
         setColor(10);
@@ -510,14 +841,14 @@ void ATCSystem::findSafeRoute() {
         cout << "\n  Route: ";
         setColor(11);
 
-        for (int i = 0; i < pathLen; i++) {
+        for (int i = 0; i < path.getSize(); i++) {
             if (graph.getIsAirport(path[i]))
                 setColor(10); 
             else
                 setColor(14);
             cout << graph.getNodeName(path[i]);
             setColor(15);
-            if (i < pathLen - 1) {
+            if (i < path.getSize() - 1) {
                 setColor(13); 
                 cout << " -> ";
             }
@@ -548,18 +879,18 @@ void ATCSystem::moveFlight() {
         }
         setColor(15);
 
-        Aircraft* flight = registry.search(flightID);
-        if (!flight) {
+        Aircraft flight;
+        if (!registry.search(flightID, flight)) {
             throw FlightNotFoundException(flightID);
         }
-        if (!flight->inAir) {
+        if (!flight.inAir) {
             throw InvalidFlightDataException("Flight is not in air");
         }
 
         graph.displayNodes();
         cout << "\n  Current Position: Node ";
         setColor(14);
-        cout << flight->graphNode << " (" << graph.getNodeName(flight->graphNode) << ")" << endl;
+        cout << flight.graphNode << " (" << graph.getNodeName(flight.graphNode) << ")" << endl;
         setColor(11);
         cout << "  Enter Destination Node ID: ";
         setColor(10);
@@ -570,22 +901,12 @@ void ATCSystem::moveFlight() {
         }
         setColor(15);
 
-        int newX = graph.getNodeX(destNode);
-        int newY = graph.getNodeY(destNode);
-
-        checkCollision(newX, newY, flightID);
-
-        flight->graphNode = destNode;
-        flight->gridX = newX;
-        flight->gridY = newY;
-        flight->fuelLevel -= 5;
-        if (flight->fuelLevel < 0) flight->fuelLevel = 0;
-
-        if (flight->fuelLevel < 10 && flight->priority > 2) {
-            flight->priority = 2;
-            landingQueue.decreaseKey(flightID, 2);
+        if (relocateFlight(flightID, destNode)) {
             printWarning("LOW FUEL ALERT! Priority upgraded to HIGH!");
         }
+        registry.search(flightID, flight);
+        int newX = flight.gridX;
+        int newY = flight.gridY;
 
         setColor(10); 
         cout << "\n  ========================================" << endl;
@@ -597,10 +918,10 @@ void ATCSystem::moveFlight() {
         cout << graph.getNodeName(destNode) << " (" << newX << ", " << newY << ")" << endl;
         setColor(15);
         cout << "  Remaining Fuel: ";
-        if (flight->fuelLevel < 20) setColor(12);
-        else if (flight->fuelLevel < 50) setColor(14);
+        if (flight.fuelLevel < 20) setColor(12);
+        else if (flight.fuelLevel < 50) setColor(14);
         else setColor(10);
-        cout << flight->fuelLevel << "%" << endl;
+        cout << flight.fuelLevel << "%" << endl;
         setColor(10);
         cout << "  ========================================" << endl;
         setColor(15);
@@ -614,8 +935,7 @@ void ATCSystem::moveFlight() {
 
 void ATCSystem::saveState() {
     try {
-        registry.saveToFile("flights.txt");
-        flightLog.saveToFile("flightlog.txt");
+        writeState();
         printSuccess("Data saved to files!");
     }
     catch (const ATCException& e) {
@@ -625,8 +945,7 @@ void ATCSystem::saveState() {
 
 void ATCSystem::loadState() {
     try {
-        registry.loadFromFile("flights.txt");
-        flightLog.loadFromFile("flightlog.txt");
+        readState();
         printSuccess("Data loaded from files!");
     }
     catch (const ATCException& e) {
@@ -6,23 +6,62 @@
 #include "Graph.h"
 #include "HashTable.h"
 #include "MinHeap.h"
-#include "AVLTree.h"
+#include "FlightLog.h"
 #include "Radar.h"
+#include "ConflictDetector.h"
+#include "Simulation.h"
+#include "Journal.h"
 
 class ATCSystem {
 private:
     Graph graph;
+    // Owns every Aircraft record; declared before the structures that hold
+    // handles into it so it is destroyed after them.
+    AircraftStore fleet;
     HashTable registry;
     MinHeap landingQueue;
-    AVLTree flightLog;
+    FlightLog flightLog;
     Radar radar;
+    ConflictDetector conflictDetector;
+    SimulationEngine simulation;
 
-    void initializeAirspace();
+    // Mutations since the last snapshot (state.bin). The journal records
+    // only while snapshot + committed journal describe the in-memory state
+    // up to the pending records; otherwise the next save writes a full
+    // snapshot.
+    Journal journal;
+    unsigned int snapshotGeneration;
+
+    void loadDefaultAirspace();
+    void initializeAirspace(const char* airspaceFile);
     void displayRadar();
+    void displaySeparationAlerts();
     void checkCollision(int x, int y, const char* excludeFlightID = nullptr);
+    void writeSnapshot();
+    void replayJournal(const DynamicArray<JournalRecord>& records);
+    void queueAirborneFlights();
 
 public:
-    ATCSystem();
+    ATCSystem(const char* airspaceFile = nullptr);
+
+    // Core operations shared by the interactive menu and script mode. They
+    // validate input, update every structure involved and throw an
+    // ATCException on failure, without any console I/O.
+    int spawnFlight(Aircraft flight, int nodeID);
+    bool relocateFlight(const char* flightID, int destNode);
+    bool applyEmergency(const char* flightID, int emergencyType);
+    Aircraft landNextFlight();
+    int routeToSafety(const char* flightID, DynamicArray<int>& path);
+    bool findFlight(const char* flightID, Aircraft& flight) const;
+    const Graph& getGraph() const;
+    const FlightLog& getFlightLog() const;
+    void writeState();
+    void readState();
+    void exportText(const char* flightsFile, const char* logFile);
+    void importText(const char* flightsFile, const char* logFile);
+    TickStats runSimulationTick();
+    void setSimulationThreads(int threadCount);
+
     void showAirspaceVisualizer();
     void addFlight();
     void declareEmergency();
@@ -0,0 +1,143 @@
+#include "AircraftStore.h"
+#include "Exceptions.h"
+#include <cstring>
+
+using namespace std;
+
+AircraftStore::AircraftStore() : nextHandle(0), liveCount(0) {}
+
+int AircraftStore::getHandleLimit() const { return nextHandle; }
+
+int AircraftStore::getLiveCount() const { return liveCount; }
+
+void AircraftStore::checkHandle(int handle) const {
+    if (handle < 0 || handle >= nextHandle) {
+        throw InvalidInputException("Invalid aircraft handle");
+    }
+}
+
+// Sizes every column for handleCount handles ahead of a bulk load.
+void AircraftStore::reserve(int handleCount) {
+    fuelColumn.reserve(handleCount);
+    priorityColumn.reserve(handleCount);
+    xColumn.reserve(handleCount);
+    yColumn.reserve(handleCount);
+    nodeColumn.reserve(handleCount);
+    timestampColumn.reserve(handleCount);
+    inAirColumn.reserve(handleCount);
+    generationColumn.reserve(handleCount);
+    details.reserve(handleCount);
+    refCounts.reserve(handleCount);
+}
+
+// New record holding one reference, owned by the caller.
+int AircraftStore::allocate(const Aircraft& aircraft) {
+    int handle;
+    if (!freeHandles.isEmpty()) {
+        handle = freeHandles.back();
+        freeHandles.popBack();
+    }
+    else {
+        handle = nextHandle;
+        fuelColumn.pushBack(0);
+        priorityColumn.pushBack(0);
+        xColumn.pushBack(0);
+        yColumn.pushBack(0);
+        nodeColumn.pushBack(0);
+        timestampColumn.pushBack(0);
+        inAirColumn.pushBack(0);
+        generationColumn.pushBack(0);
+        details.pushBack(AircraftDetails());
+        refCounts.pushBack(0);
+        nextHandle++;
+    }
+
+    set(handle, aircraft);
+    generationColumn[handle]++;
+    refCounts[handle] = 1;
+    liveCount++;
+    return handle;
+}
+
+// count new default records after the current handles, each holding one
+// reference owned by the caller, for a bulk load to fill with set(). Every
+// column grows once; the free list is left for later allocations.
+int AircraftStore::allocateRange(int count) {
+    int first = nextHandle;
+    int limit = first + count;
+    fuelColumn.resize(limit, 0);
+    priorityColumn.resize(limit, 0);
+    xColumn.resize(limit, 0);
+    yColumn.resize(limit, 0);
+    nodeColumn.resize(limit, 0);
+    timestampColumn.resize(limit, 0);
+    inAirColumn.resize(limit, 0);
+    generationColumn.resize(limit, 1);
+    details.resize(limit, AircraftDetails());
+    refCounts.resize(limit, 1);
+    nextHandle = limit;
+    liveCount += count;
+    return first;
+}
+
+void AircraftStore::retain(int handle) {
+    if (!isLive(handle)) {
+        throw InvalidInputException("Invalid aircraft handle");
+    }
+    refCounts[handle]++;
+}
+
+void AircraftStore::release(int handle) {
+    if (!isLive(handle)) {
+        throw InvalidInputException("Invalid aircraft handle");
+    }
+    if (--refCounts[handle] == 0) {
+        set(handle, Aircraft());
+        freeHandles.pushBack(handle);
+        liveCount--;
+    }
+}
+
+bool AircraftStore::isLive(int handle) const {
+    return handle >= 0 && handle < nextHandle && refCounts[handle] > 0;
+}
+
+Aircraft AircraftStore::get(int handle) const {
+    checkHandle(handle);
+    const AircraftDetails& d = details[handle];
+    Aircraft a;
+    memcpy(a.flightID, d.flightID, sizeof(a.flightID));
+    memcpy(a.model, d.model, sizeof(a.model));
+    memcpy(a.origin, d.origin, sizeof(a.origin));
+    memcpy(a.destination, d.destination, sizeof(a.destination));
+    a.fuelLevel = fuelColumn[handle];
+    a.priority = priorityColumn[handle];
+    a.gridX = xColumn[handle];
+    a.gridY = yColumn[handle];
+    a.graphNode = nodeColumn[handle];
+    a.inAir = inAirColumn[handle] != 0;
+    a.timestamp = timestampColumn[handle];
+    return a;
+}
+
+void AircraftStore::set(int handle, const Aircraft& aircraft) {
+    checkHandle(handle);
+    AircraftDetails& d = details[handle];
+    memcpy(d.flightID, aircraft.flightID, sizeof(d.flightID));
+    memcpy(d.model, aircraft.model, sizeof(d.model));
+    memcpy(d.origin, aircraft.origin, sizeof(d.origin));
+    memcpy(d.destination, aircraft.destination, sizeof(d.destination));
+    fuelColumn[handle] = aircraft.fuelLevel;
+    priorityColumn[handle] = aircraft.priority;
+    xColumn[handle] = aircraft.gridX;
+    yColumn[handle] = aircraft.gridY;
+    nodeColumn[handle] = aircraft.graphNode;
+    inAirColumn[handle] = aircraft.inAir ? 1 : 0;
+    timestampColumn[handle] = aircraft.timestamp;
+}
+
+void AircraftStore::setPosition(int handle, int node, int x, int y) {
+    nodeColumn[handle] = node;
+    xColumn[handle] = x;
+    yColumn[handle] = y;
+}
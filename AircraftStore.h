@@ -0,0 +1,94 @@
+#ifndef AIRCRAFTSTORE_H
+#define AIRCRAFTSTORE_H
+
+#include "Constants.h"
+#include "Aircraft.h"
+#include "DynamicArray.h"
+
+// Cold part of an aircraft record: strings read for lookup by ID, display
+// and file I/O, but not by per-tick sweeps.
+struct AircraftDetails {
+    char flightID[20];
+    char model[30];
+    char origin[20];
+    char destination[20];
+};
+
+// The one copy of every Aircraft record, addressed by stable integer handles.
+// The registry and the landing queue refer to records by handle. The flight
+// log does not: it interns the strings it needs when an entry is logged.
+//
+// Records are stored column-wise: each hot numeric field has its own
+// contiguous array indexed by handle, and the strings live apart in
+// AircraftDetails. Sweeps over fuel or positions then touch only the bytes
+// they use. Aircraft remains the value type for whole-record reads and
+// writes. Column pointers are invalidated when allocate() grows the store.
+//
+// Each holder takes a reference on the records it keeps (the registry, one
+// per flight; the landing queue only queues registered flights); a record
+// is reset and its handle recycled only when the last reference is
+// released. A free handle reads as a default Aircraft, which is never in
+// the air.
+class AircraftStore {
+private:
+    DynamicArray<int> fuelColumn;
+    DynamicArray<int> priorityColumn;
+    DynamicArray<int> xColumn;
+    DynamicArray<int> yColumn;
+    DynamicArray<int> nodeColumn;
+    DynamicArray<int> timestampColumn;
+    DynamicArray<unsigned char> inAirColumn;
+    DynamicArray<unsigned int> generationColumn;
+    DynamicArray<AircraftDetails> details;
+
+    DynamicArray<int> refCounts;
+    DynamicArray<int> freeHandles;
+    int nextHandle;
+    int liveCount;
+
+    void checkHandle(int handle) const;
+
+public:
+    AircraftStore();
+    AircraftStore(const AircraftStore&) = delete;
+    AircraftStore& operator=(const AircraftStore&) = delete;
+
+    void reserve(int handleCount);
+    int allocate(const Aircraft& aircraft);
+    int allocateRange(int count);
+    void retain(int handle);
+    void release(int handle);
+    bool isLive(int handle) const;
+    int getHandleLimit() const;
+    int getLiveCount() const;
+
+    Aircraft get(int handle) const;
+    void set(int handle, const Aircraft& aircraft);
+
+    // Unchecked per-field access; handle must be below getHandleLimit().
+    int& fuelLevel(int handle) { return fuelColumn[handle]; }
+    int fuelLevel(int handle) const { return fuelColumn[handle]; }
+    int& priority(int handle) { return priorityColumn[handle]; }
+    int priority(int handle) const { return priorityColumn[handle]; }
+    int gridX(int handle) const { return xColumn[handle]; }
+    int gridY(int handle) const { return yColumn[handle]; }
+    int graphNode(int handle) const { return nodeColumn[handle]; }
+    int timestamp(int handle) const { return timestampColumn[handle]; }
+    bool inAir(int handle) const { return inAirColumn[handle] != 0; }
+    void setPosition(int handle, int node, int x, int y);
+    void setInAir(int handle, bool airborne) { inAirColumn[handle] = airborne ? 1 : 0; }
+    // Bumped every time the handle is allocated, so holders of per-handle
+    // state can tell a recycled handle from the record they saw before.
+    unsigned int generation(int handle) const { return generationColumn[handle]; }
+    const AircraftDetails& getDetails(int handle) const { return details[handle]; }
+    const char* flightID(int handle) const { return details[handle].flightID; }
+
+    // Whole columns, getHandleLimit() entries each, for sweeps.
+    int* fuelData() { return fuelColumn.getData(); }
+    int* priorityData() { return priorityColumn.getData(); }
+    const int* xData() const { return xColumn.getData(); }
+    const int* yData() const { return yColumn.getData(); }
+    const unsigned char* inAirData() const { return inAirColumn.getData(); }
+};
+
+#endif
@@ -1,8 +1,17 @@
 #ifndef COLORS_H
 #define COLORS_H
 
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
 #define NOMINMAX
+#endif
 #include <windows.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#endif
 
 // Color codes
 // 0 = Black       8 = Dark Gray
@@ -14,8 +23,36 @@
 // 6 = Dark Yellow 14 = Yellow
 // 7 = Light Gray  15 = White
 
+// ANSI escape for a console color code. Console codes are IRGB bit sets while
+// ANSI numbers colors BGR, hence the table.
+inline const char* ansiColor(int color) {
+    static const char* codes[16] = {
+        "\x1b[30m", "\x1b[34m", "\x1b[32m", "\x1b[36m",
+        "\x1b[31m", "\x1b[35m", "\x1b[33m", "\x1b[37m",
+        "\x1b[90m", "\x1b[94m", "\x1b[92m", "\x1b[96m",
+        "\x1b[91m", "\x1b[95m", "\x1b[93m", "\x1b[97m"
+    };
+    return codes[color & 15];
+}
+
 inline void setColor(int color) {
+#ifdef _WIN32
     SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+#else
+    std::cout << ansiColor(color);
+#endif
+}
+
+// Lets the Windows console interpret the ANSI sequences used by buffered
+// renderers such as Radar::display. Other terminals understand them already.
+inline void enableAnsiColors() {
+#ifdef _WIN32
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(out, &mode)) {
+        SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
 }
 
 #endif
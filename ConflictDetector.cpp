@@ -0,0 +1,114 @@
+#include "ConflictDetector.h"
+#include "Exceptions.h"
+
+ConflictDetector::ConflictDetector() : buckets(nullptr) {}
+
+ConflictDetector::~ConflictDetector() {
+    delete buckets;
+}
+
+int ConflictDetector::distanceSquared(int x1, int y1, int x2, int y2) {
+    int dx = x1 - x2;
+    int dy = y1 - y2;
+    return dx * dx + dy * dy;
+}
+
+int ConflictDetector::getTrackedCount() const {
+    return airborne.getSize();
+}
+
+void ConflictDetector::rebuild(const HashTable& registry, int cellSize) {
+    if (cellSize < 1) cellSize = 1;
+
+    if (buckets == nullptr || buckets->getCellSize() != cellSize) {
+        delete buckets;
+        buckets = nullptr;
+        buckets = new SpatialIndex(cellSize);
+    }
+    else {
+        buckets->clear();
+    }
+
+    airborne.clear();
+    // Straight sweep over the store's position and status columns.
+    const AircraftStore& store = registry.getStore();
+    const unsigned char* inAir = store.inAirData();
+    const int* xs = store.xData();
+    const int* ys = store.yData();
+    int limit = store.getHandleLimit();
+    for (int h = 0; h < limit; h++) {
+        if (inAir[h] && xs[h] >= 0 && ys[h] >= 0) {
+            buckets->insert(h, xs[h], ys[h]);
+            airborne.pushBack(h);
+        }
+    }
+}
+
+// Each aircraft is compared with the rest of its own cell and with four of
+// its eight neighbours (E, SE, S, SW), so every pair is reported once.
+void ConflictDetector::findConflicts(int separation, DynamicArray<ConflictPair>& pairs) const {
+    pairs.clear();
+    if (buckets == nullptr) return;
+    if (separation > buckets->getCellSize()) {
+        throw InvalidInputException("Separation wider than the conflict grid cells");
+    }
+
+    static const int neighbourDX[4] = { 1, 1, 0, -1 };
+    static const int neighbourDY[4] = { 0, 1, 1, 1 };
+    int limit = separation * separation;
+    int cellSize = buckets->getCellSize();
+
+    for (int i = 0; i < airborne.getSize(); i++) {
+        int h = airborne[i];
+        int x = buckets->getX(h);
+        int y = buckets->getY(h);
+
+        for (int other = buckets->nextInSameCell(h); other != -1; other = buckets->nextInSameCell(other)) {
+            int d = distanceSquared(x, y, buckets->getX(other), buckets->getY(other));
+            if (d <= limit) {
+                ConflictPair pair;
+                pair.first = h < other ? h : other;
+                pair.second = h < other ? other : h;
+                pair.distanceSquared = d;
+                pairs.pushBack(pair);
+            }
+        }
+
+        for (int n = 0; n < 4; n++) {
+            int cx = x / cellSize + neighbourDX[n];
+            int cy = y / cellSize + neighbourDY[n];
+            for (int other = buckets->firstInCell(cx, cy); other != -1; other = buckets->nextInSameCell(other)) {
+                int d = distanceSquared(x, y, buckets->getX(other), buckets->getY(other));
+                if (d <= limit) {
+                    ConflictPair pair;
+                    pair.first = h < other ? h : other;
+                    pair.second = h < other ? other : h;
+                    pair.distanceSquared = d;
+                    pairs.pushBack(pair);
+                }
+            }
+        }
+    }
+}
+
+void ConflictDetector::findWithinRadius(int x, int y, int radius, DynamicArray<int>& handles) const {
+    handles.clear();
+    if (buckets == nullptr || radius < 0) return;
+
+    int cellSize = buckets->getCellSize();
+    int limit = radius * radius;
+    int minX = (x - radius) / cellSize, maxX = (x + radius) / cellSize;
+    int minY = (y - radius) / cellSize, maxY = (y + radius) / cellSize;
+    if (x - radius < 0) minX = 0;
+    if (y - radius < 0) minY = 0;
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            for (int h = buckets->firstInCell(cx, cy); h != -1; h = buckets->nextInSameCell(h)) {
+                if (distanceSquared(x, y, buckets->getX(h), buckets->getY(h)) <= limit) {
+                    handles.pushBack(h);
+                }
+            }
+        }
+    }
+}
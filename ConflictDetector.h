@@ -0,0 +1,34 @@
+#ifndef CONFLICTDETECTOR_H
+#define CONFLICTDETECTOR_H
+
+#include "HashTable.h"
+#include "SpatialIndex.h"
+#include "DynamicArray.h"
+
+struct ConflictPair {
+    int first;              // registry handles, first < second
+    int second;
+    int distanceSquared;
+};
+
+// Separation checks over all airborne aircraft. rebuild() buckets positions
+// into a uniform grid whose cells are as wide as the separation distance,
+// so every conflicting pair sits in the same or a neighbouring cell and a
+// full sweep costs O(n + pairs) instead of O(n^2).
+class ConflictDetector {
+private:
+    SpatialIndex* buckets;
+    DynamicArray<int> airborne;
+
+    static int distanceSquared(int x1, int y1, int x2, int y2);
+
+public:
+    ConflictDetector();
+    ~ConflictDetector();
+    void rebuild(const HashTable& registry, int cellSize);
+    void findConflicts(int separation, DynamicArray<ConflictPair>& pairs) const;
+    void findWithinRadius(int x, int y, int radius, DynamicArray<int>& handles) const;
+    int getTrackedCount() const;
+};
+
+#endif
@@ -3,10 +3,18 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
+#include "Platform.h"
+
 const int GRID_SIZE = 20;
-const int MAX_FLIGHTS = 100;
-const int HASH_TABLE_SIZE = 101;
-const int MAX_NODES = 20;
-const int INF = 999999;
+const int HASH_TABLE_INITIAL_CAPACITY = 64;
+const int HASH_TABLE_MAX_LOAD_PERCENT = 85;
+const int INF = 1000000000;
+const int MIN_SEPARATION = 2;
+const int SIM_AIRSPEED = 10;             // route distance flown per tick
+const int SIM_FUEL_BURN_PER_TICK = 1;
+const int SIM_PARALLEL_MIN_HANDLES = 4096;  // smaller ticks run on one thread
+const int SIM_PARTITIONS_PER_THREAD = 4;
+const int JOURNAL_MIN_COMPACT_RECORDS = 1024; // journal length that may trigger a snapshot
+const int LOG_CHUNK_SIZE = 1024;         // flight log entries per chunk
 
 #endif
@@ -0,0 +1,100 @@
+#ifndef DYNAMICARRAY_H
+#define DYNAMICARRAY_H
+
+#include "Exceptions.h"
+#include <new>
+
+// Growable array used in place of fixed MAX_* buffers. Capacity doubles on
+// demand, so pushBack is amortized O(1).
+template <typename T>
+class DynamicArray {
+private:
+    T* data;
+    int count;
+    int capacity;
+
+    void grow(int minCapacity) {
+        int newCapacity = capacity == 0 ? 16 : capacity;
+        while (newCapacity < minCapacity) {
+            newCapacity *= 2;
+        }
+
+        T* grown = new(std::nothrow) T[newCapacity];
+        if (grown == nullptr) {
+            throw MemoryAllocationException();
+        }
+        for (int i = 0; i < count; i++) {
+            grown[i] = data[i];
+        }
+        delete[] data;
+        data = grown;
+        capacity = newCapacity;
+    }
+
+public:
+    DynamicArray() : data(nullptr), count(0), capacity(0) {}
+
+    DynamicArray(const DynamicArray& other) : data(nullptr), count(0), capacity(0) {
+        reserve(other.count);
+        for (int i = 0; i < other.count; i++) {
+            data[i] = other.data[i];
+        }
+        count = other.count;
+    }
+
+    DynamicArray& operator=(const DynamicArray& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.count);
+            for (int i = 0; i < other.count; i++) {
+                data[i] = other.data[i];
+            }
+            count = other.count;
+        }
+        return *this;
+    }
+
+    ~DynamicArray() {
+        delete[] data;
+    }
+
+    void reserve(int minCapacity) {
+        if (minCapacity > capacity) {
+            grow(minCapacity);
+        }
+    }
+
+    // Grows or shrinks the logical size; new elements are set to fill.
+    void resize(int newSize, const T& fill = T()) {
+        reserve(newSize);
+        for (int i = count; i < newSize; i++) {
+            data[i] = fill;
+        }
+        count = newSize;
+    }
+
+    void pushBack(const T& value) {
+        if (count == capacity) {
+            grow(count + 1);
+        }
+        data[count++] = value;
+    }
+
+    void popBack() {
+        if (count > 0) count--;
+    }
+
+    void clear() { count = 0; }
+
+    T& operator[](int i) { return data[i]; }
+    const T& operator[](int i) const { return data[i]; }
+    T& back() { return data[count - 1]; }
+    const T& back() const { return data[count - 1]; }
+    T* getData() { return data; }
+    const T* getData() const { return data; }
+    int getSize() const { return count; }
+    int getCapacity() const { return capacity; }
+    bool isEmpty() const { return count == 0; }
+};
+
+#endif
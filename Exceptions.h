@@ -3,6 +3,8 @@
 
 #include <exception>
 #include <cstring>
+#include <cstdio>
+#include "Platform.h"
 
 class ATCException : public std::exception {
 protected:
@@ -42,12 +44,6 @@ public:
     }
 };
 
-class NodeFullException : public ATCException {
-public:
-    NodeFullException() : ATCException("Maximum nodes reached in graph") {
-    }
-};
-
 class NoRouteException : public ATCException {
 public:
     NoRouteException() : ATCException("No route found to any airport") {
@@ -61,12 +57,6 @@ public:
     }
 };
 
-class HeapFullException : public ATCException {
-public:
-    HeapFullException() : ATCException("Landing queue is full") {
-    }
-};
-
 class HeapEmptyException : public ATCException {
 public:
     HeapEmptyException() : ATCException("Landing queue is empty") {
@@ -84,6 +74,29 @@ public:
     FileException(const char* filename) : ATCException("File operation failed: ") {
         strcat_s(message, 256, filename);
     }
+
+protected:
+    // For subclasses that format their own message.
+    FileException() : ATCException("") {
+    }
+};
+
+class SnapshotFormatException : public ATCException {
+public:
+    SnapshotFormatException(const char* filename, const char* reason) : ATCException("Invalid snapshot ") {
+        strcat_s(message, 256, filename);
+        strcat_s(message, 256, ": ");
+        strcat_s(message, 256, reason);
+    }
+};
+
+// Malformed line in a pipe-delimited data file. snprintf truncates rather
+// than overflowing when the path is long.
+class ParseException : public FileException {
+public:
+    ParseException(const char* filename, long long line, const char* reason) : FileException() {
+        snprintf(message, sizeof(message), "%s line %lld: %s", filename, line, reason);
+    }
 };
 
 class InvalidInputException : public ATCException {
@@ -0,0 +1,483 @@
+#include "FlightLog.h"
+#include "Exceptions.h"
+#include "Colors.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include <ctime>
+#include <new>
+
+using namespace std;
+
+LogCursor::LogCursor() : log(nullptr), chunk(0), offset(0), lastTimestamp(INT_MAX), remaining(0) {}
+
+bool LogCursor::isValid() const {
+    return log != nullptr && remaining > 0 && chunk < log->chunks.getSize()
+        && log->chunks[chunk]->timestamps[offset] <= lastTimestamp;
+}
+
+void LogCursor::next() {
+    if (log == nullptr || chunk >= log->chunks.getSize()) return;
+    remaining--;
+    if (++offset == log->chunks[chunk]->count) {
+        chunk++;
+        offset = 0;
+    }
+}
+
+const LogEvent& LogCursor::event() const {
+    return log->events[log->chunks[chunk]->events[offset]];
+}
+
+int LogCursor::timestamp() const {
+    return log->chunks[chunk]->timestamps[offset];
+}
+
+const char* LogCursor::flightID() const {
+    return log->flightIDs.get(event().flight);
+}
+
+const char* LogCursor::origin() const {
+    return log->strings.get(event().origin);
+}
+
+const char* LogCursor::destination() const {
+    return log->strings.get(event().destination);
+}
+
+const char* LogCursor::status() const {
+    return log->strings.get(event().status);
+}
+
+HistoryCursor::HistoryCursor() : log(nullptr), flight(-1), entry(-1) {}
+
+bool HistoryCursor::isValid() const {
+    return log != nullptr && entry != -1;
+}
+
+void HistoryCursor::next() {
+    if (isValid()) entry = log->events[entry].next;
+}
+
+int HistoryCursor::timestamp() const {
+    return log->events[entry].timestamp;
+}
+
+const char* HistoryCursor::flightID() const {
+    return log->flightIDs.get(flight);
+}
+
+const char* HistoryCursor::origin() const {
+    return log->strings.get(log->events[entry].origin);
+}
+
+const char* HistoryCursor::destination() const {
+    return log->strings.get(log->events[entry].destination);
+}
+
+const char* HistoryCursor::status() const {
+    return log->strings.get(log->events[entry].status);
+}
+
+FlightLog::FlightLog(AircraftStore& store) : store(store), count(0) {}
+
+FlightLog::~FlightLog() {
+    for (int i = 0; i < chunks.getSize(); i++) {
+        delete chunks[i];
+    }
+}
+
+bool FlightLog::isEmpty() const {
+    return count == 0;
+}
+
+int FlightLog::getCount() const {
+    return count;
+}
+
+long long FlightLog::getMemoryBytes() const {
+    return (long long)chunks.getSize() * sizeof(LogChunk)
+        + (long long)chunks.getCapacity() * sizeof(LogChunk*)
+        + (long long)chunkStart.getCapacity() * sizeof(int)
+        + (long long)events.getCapacity() * sizeof(LogEvent)
+        + (long long)histories.getCapacity() * sizeof(FlightHistory)
+        + flightIDs.getMemoryBytes()
+        + strings.getMemoryBytes();
+}
+
+LogChunk* FlightLog::appendChunk() {
+    LogChunk* chunk = new(nothrow) LogChunk;
+    if (chunk == nullptr) {
+        throw MemoryAllocationException();
+    }
+    chunk->count = 0;
+    try {
+        chunks.pushBack(chunk);
+        chunkStart.pushBack(count);
+    }
+    catch (...) {
+        if (chunks.getSize() > chunkStart.getSize()) chunks.popBack();
+        delete chunk;
+        throw;
+    }
+    return chunk;
+}
+
+// Moves the upper half of a full chunk into a new chunk right after it.
+void FlightLog::splitChunk(int chunk) {
+    LogChunk* full = chunks[chunk];
+    LogChunk* upper = appendChunk();
+    int keep = full->count / 2;
+    int moved = full->count - keep;
+    memcpy(upper->timestamps, full->timestamps + keep, moved * sizeof(int));
+    memcpy(upper->events, full->events + keep, moved * sizeof(int));
+    upper->count = moved;
+    full->count = keep;
+
+    // appendChunk put the new chunk last; slide it into place.
+    for (int i = chunks.getSize() - 1; i > chunk + 1; i--) {
+        chunks[i] = chunks[i - 1];
+        chunkStart[i] = chunkStart[i - 1];
+    }
+    chunks[chunk + 1] = upper;
+    chunkStart[chunk + 1] = chunkStart[chunk] + keep;
+}
+
+// Last chunk whose first entry is at or before timestamp (0 if none), i.e.
+// the chunk an out-of-order entry belongs in.
+int FlightLog::findChunk(int timestamp) const {
+    int low = 0, high = chunks.getSize() - 1;
+    while (low < high) {
+        int mid = low + (high - low + 1) / 2;
+        if (chunks[mid]->timestamps[0] <= timestamp) low = mid;
+        else high = mid - 1;
+    }
+    return low;
+}
+
+// Chunk holding the entry at 0-based rank (rank < count).
+int FlightLog::locate(int rank) const {
+    int low = 0, high = chunks.getSize() - 1;
+    while (low < high) {
+        int mid = low + (high - low + 1) / 2;
+        if (chunkStart[mid] <= rank) low = mid;
+        else high = mid - 1;
+    }
+    return low;
+}
+
+// Entries with timestamp below bound: first the chunk where they stop,
+// then the position inside it.
+int FlightLog::countBelow(long long bound) const {
+    int low = 0, high = chunks.getSize();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const LogChunk* c = chunks[mid];
+        if (c->timestamps[c->count - 1] < bound) low = mid + 1;
+        else high = mid;
+    }
+    if (low == chunks.getSize()) return count;
+
+    const LogChunk* c = chunks[low];
+    int first = 0, last = c->count;
+    while (first < last) {
+        int mid = first + (last - first) / 2;
+        if (c->timestamps[mid] < bound) first = mid + 1;
+        else last = mid;
+    }
+    return chunkStart[low] + first;
+}
+
+// Sizes the per-entry storage for entries more log entries ahead of a bulk
+// load. The string table and the per-flight lists grow with the number of
+// distinct strings, which the entry count says nothing about.
+void FlightLog::reserve(int entries) {
+    long long total = (long long)count + entries;
+    if (total > INT_MAX) total = INT_MAX;
+    chunks.reserve((int)(total / LOG_CHUNK_SIZE) + 1);
+    chunkStart.reserve((int)(total / LOG_CHUNK_SIZE) + 1);
+    events.reserve((int)total);
+}
+
+void FlightLog::insert(int timestamp, const char* flightID, const char* origin,
+    const char* destination, const char* status) {
+    if (flightID == nullptr || strlen(flightID) == 0) {
+        throw InvalidFlightDataException("Cannot log aircraft with empty flight ID");
+    }
+    if (status == nullptr || strlen(status) == 0) {
+        throw InvalidInputException("Status cannot be empty");
+    }
+    int flight = flightIDs.intern(flightID);
+    int from = strings.intern(origin != nullptr ? origin : "");
+    int to = strings.intern(destination != nullptr ? destination : "");
+    int state = strings.intern(status);
+
+    // Make room for the event and its flight's list first, so a failed
+    // allocation leaves the chunks and the events in step.
+    if (histories.getSize() < flightIDs.getCount()) {
+        FlightHistory empty = { -1, -1, 0 };
+        histories.resize(flightIDs.getCount(), empty);
+    }
+    events.reserve(events.getSize() + 1);
+
+    LogChunk* target;
+    int position;
+    if (count == 0 || timestamp >= chunks.back()->timestamps[chunks.back()->count - 1]) {
+        target = chunks.isEmpty() || chunks.back()->count == LOG_CHUNK_SIZE ? appendChunk() : chunks.back();
+        position = target->count;
+    }
+    else {
+        int chunk = findChunk(timestamp);
+        if (chunks[chunk]->count == LOG_CHUNK_SIZE) {
+            splitChunk(chunk);
+            if (chunks[chunk + 1]->timestamps[0] <= timestamp) chunk++;
+        }
+        target = chunks[chunk];
+
+        // After any equal timestamps, as an append would be.
+        int first = 0, last = target->count;
+        while (first < last) {
+            int mid = first + (last - first) / 2;
+            if (target->timestamps[mid] <= timestamp) first = mid + 1;
+            else last = mid;
+        }
+        position = first;
+
+        int tail = target->count - position;
+        memmove(target->timestamps + position + 1, target->timestamps + position, tail * sizeof(int));
+        memmove(target->events + position + 1, target->events + position, tail * sizeof(int));
+        for (int i = chunk + 1; i < chunks.getSize(); i++) {
+            chunkStart[i]++;
+        }
+    }
+
+    LogEvent event = { timestamp, flight, from, to, state, -1 };
+    target->timestamps[position] = timestamp;
+    target->events[position] = events.getSize();
+    target->count++;
+    count++;
+    events.pushBack(event);
+    linkHistory(flight, events.getSize() - 1);
+}
+
+// Links a new event into its flight's list after any events with the same
+// or an earlier timestamp.
+void FlightLog::linkHistory(int flight, int id) {
+    FlightHistory& list = histories[flight];
+    LogEvent& event = events[id];
+    if (list.head == -1) {
+        list.head = list.tail = id;
+    }
+    else if (events[list.tail].timestamp <= event.timestamp) {
+        events[list.tail].next = id;
+        list.tail = id;
+    }
+    else if (event.timestamp < events[list.head].timestamp) {
+        event.next = list.head;
+        list.head = id;
+    }
+    else {
+        // The tail is later than event, so the walk stops before it.
+        int previous = list.head;
+        while (events[events[previous].next].timestamp <= event.timestamp) {
+            previous = events[previous].next;
+        }
+        event.next = events[previous].next;
+        events[previous].next = id;
+    }
+    list.count++;
+}
+
+// Logs an event for a record in the store. The strings are copied into the
+// log, so the record may be removed or recycled afterwards.
+void FlightLog::insert(int handle, int timestamp, const char* status) {
+    if (!store.isLive(handle)) {
+        throw InvalidInputException("Invalid aircraft handle");
+    }
+    const AircraftDetails& d = store.getDetails(handle);
+    insert(timestamp, d.flightID, d.origin, d.destination, status);
+}
+
+// Logs an aircraft that is not tracked elsewhere, e.g. a loaded or
+// generated history entry.
+void FlightLog::insert(const Aircraft& aircraft, const char* status) {
+    insert(aircraft.timestamp, aircraft.flightID, aircraft.origin, aircraft.destination, status);
+}
+
+// Counts entries with timestamp before the given one, i.e. the rank of the
+// first entry at or after it, in O(log n).
+int FlightLog::countBefore(int timestamp) const {
+    return countBelow(timestamp);
+}
+
+// Entries with from <= timestamp <= to, in O(log n).
+int FlightLog::countRange(int from, int to) const {
+    if (from > to) return 0;
+    return countBelow((long long)to + 1) - countBelow(from);
+}
+
+// Walks the entries with from <= timestamp <= to in order.
+LogCursor FlightLog::range(int from, int to) const {
+    LogCursor cursor = fromRank(countBefore(from), count);
+    cursor.lastTimestamp = to;
+    return cursor;
+}
+
+// Walks at most limit entries starting at 0-based position rank in
+// timestamp order, so page k of size m is fromRank(k * m, m) and the last
+// n entries are fromRank(getCount() - n, n).
+LogCursor FlightLog::fromRank(int rank, int limit) const {
+    LogCursor cursor;
+    cursor.log = this;
+    cursor.remaining = limit;
+    if (rank < 0) rank = 0;
+    if (rank >= count) {
+        cursor.chunk = chunks.getSize();
+        return cursor;
+    }
+    cursor.chunk = locate(rank);
+    cursor.offset = rank - chunkStart[cursor.chunk];
+    return cursor;
+}
+
+// Number of log entries for one flight, in O(1) average.
+int FlightLog::countFlight(const char* flightID) const {
+    int flight = flightIDs.find(flightID);
+    if (flight == -1 || flight >= histories.getSize()) return 0;
+    return histories[flight].count;
+}
+
+// Walks one flight's entries in timestamp order: a hash lookup, then O(1)
+// per entry. An unknown flight gives an empty walk.
+HistoryCursor FlightLog::history(const char* flightID) const {
+    HistoryCursor cursor;
+    cursor.log = this;
+    int flight = flightIDs.find(flightID);
+    if (flight != -1 && flight < histories.getSize()) {
+        cursor.flight = flight;
+        cursor.entry = histories[flight].head;
+    }
+    return cursor;
+}
+
+void FlightLog::printLog() const {
+    if (count == 0) {
+        setColor(14); // Yellow
+        cout << "  No flight logs available." << endl;
+        setColor(15);
+        return;
+    }
+
+    setColor(11); // Cyan
+    cout << "  +------+------------+----------+----------+-----------+" << endl;
+    cout << "  | #    | Flight ID  | Origin   | Dest     | Time      |" << endl;
+    cout << "  +------+------------+----------+----------+-----------+" << endl;
+    setColor(15);
+
+    int number = 0;
+    for (LogCursor entry = fromRank(0, count); entry.isValid(); entry.next()) {
+        time_t t = entry.timestamp();
+        char timeStr[30];
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &t);
+        strftime(timeStr, 30, "%H:%M:%S", &timeinfo);
+
+        setColor(3); // Dark Cyan
+        cout << "  | ";
+        setColor(15); // White
+        cout << setw(4) << ++number;
+        setColor(3);
+        cout << " | ";
+        setColor(11); // Cyan
+        cout << left << setw(10) << entry.flightID();
+        setColor(3);
+        cout << " | ";
+        setColor(10); // Green
+        cout << left << setw(8) << entry.origin();
+        setColor(3);
+        cout << " | ";
+        setColor(14); // Yellow
+        cout << left << setw(8) << entry.destination();
+        setColor(3);
+        cout << " | ";
+        setColor(13); // Magenta
+        cout << timeStr;
+        setColor(3);
+        cout << " |" << endl;
+
+        // Status line
+        setColor(3);
+        cout << "  |      | Status: ";
+        if (strcmp(entry.status(), "LANDED") == 0) setColor(10);     // Green
+        else if (strcmp(entry.status(), "DEPARTED") == 0) setColor(11); // Cyan
+        else setColor(14); // Yellow
+        cout << entry.status();
+        setColor(3);
+        cout << "                              |" << endl;
+        setColor(15);
+    }
+
+    setColor(11); // Cyan
+    cout << "  +------+------------+----------+----------+-----------+" << endl;
+    setColor(15);
+}
+
+void FlightLog::saveToFile(const char* filename) const {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw FileException(filename);
+    }
+
+    try {
+        for (LogCursor entry = fromRank(0, count); entry.isValid(); entry.next()) {
+            file << entry.flightID() << "|" << entry.origin() << "|" << entry.destination() << "|"
+                << entry.timestamp() << "|" << entry.status() << '\n';
+        }
+        file.close();
+        if (file.fail()) {
+            throw FileException(filename);
+        }
+    }
+    catch (...) {
+        file.close();
+        throw;
+    }
+}
+
+// Parses one flightlog.txt line (the saveToFile layout).
+void FlightLog::readRecord(const RecordReader& reader, Aircraft& aircraft, char* status, int statusSize) {
+    reader.expectFields(5);
+    reader.readText(0, aircraft.flightID, sizeof(aircraft.flightID), "flight ID", true);
+    reader.readText(1, aircraft.origin, sizeof(aircraft.origin), "origin", false);
+    reader.readText(2, aircraft.destination, sizeof(aircraft.destination), "destination", false);
+    aircraft.timestamp = reader.readInt(3, "timestamp");
+    reader.readText(4, status, statusSize, "status", true);
+}
+
+// A saved log is in timestamp order, so every line takes the append path.
+// A malformed line throws ParseException; the lines before it stay loaded.
+void FlightLog::loadFromFile(const char* filename) {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    RecordReader reader;
+    if (!reader.open(filename)) {
+        return;
+    }
+    long long lines = reader.countLines();
+    reserve(lines < INT_MAX ? (int)lines : INT_MAX);
+
+    while (reader.next()) {
+        Aircraft a;
+        char status[20];
+        readRecord(reader, a, status, sizeof(status));
+        insert(a, status);
+    }
+}
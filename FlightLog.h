@@ -0,0 +1,159 @@
+#ifndef FLIGHTLOG_H
+#define FLIGHTLOG_H
+
+#include "Constants.h"
+#include "Aircraft.h"
+#include "AircraftStore.h"
+#include "DynamicArray.h"
+#include "RecordReader.h"
+#include "StringPool.h"
+
+// Up to LOG_CHUNK_SIZE consecutive log entries in timestamp order: the
+// sort key and the id of each entry's LogEvent, 8 bytes per entry.
+struct LogChunk {
+    int count;
+    int timestamps[LOG_CHUNK_SIZE];
+    int events[LOG_CHUNK_SIZE];
+};
+
+// One log entry, stored once at a fixed id. Chunk entries move when an
+// out-of-order insert shifts or splits a chunk; events never do, so the
+// chunks and the per-flight lists both refer to them by id.
+struct LogEvent {
+    int timestamp;
+    int flight;         // flightIDs id
+    int origin;         // strings ids
+    int destination;
+    int status;
+    int next;           // later event of the same flight, or -1
+};
+
+// Head and tail of one flight's history list, indexed by the flight ID's
+// id in FlightLog::flightIDs.
+struct FlightHistory {
+    int head;
+    int tail;
+    int count;
+};
+
+class FlightLog;
+
+// Forward walk over part of the log, handed out by FlightLog::range and
+// FlightLog::fromRank. Each step is O(1). Any insert into the log
+// invalidates it.
+class LogCursor {
+private:
+    const FlightLog* log;
+    int chunk;
+    int offset;
+    int lastTimestamp;
+    int remaining;
+
+    const LogEvent& event() const;
+
+    friend class FlightLog;
+
+public:
+    LogCursor();
+    bool isValid() const;
+    void next();
+    int timestamp() const;
+    const char* flightID() const;
+    const char* origin() const;
+    const char* destination() const;
+    const char* status() const;
+};
+
+// Walk over one flight's log entries in timestamp order, handed out by
+// FlightLog::history. Each step is O(1). Unlike LogCursor it stays valid
+// across inserts, which only link new entries in.
+class HistoryCursor {
+private:
+    const FlightLog* log;
+    int flight;
+    int entry;
+
+    friend class FlightLog;
+
+public:
+    HistoryCursor();
+    bool isValid() const;
+    void next();
+    int timestamp() const;
+    const char* flightID() const;
+    const char* origin() const;
+    const char* destination() const;
+    const char* status() const;
+};
+
+// Time-ordered event log (landings and other status changes).
+//
+// Timestamps come from the clock, so events almost always arrive in order.
+// Entries therefore live in a list of sorted, column-wise chunks, each
+// chunk ending no later than the next one starts. An in-order event is
+// appended to the last chunk in O(1). An out-of-order one is placed by
+// binary search and shifted into its chunk; a full chunk is split in two
+// first. That costs O(LOG_CHUNK_SIZE + chunks). Equal timestamps keep
+// arrival order.
+//
+// chunkStart holds the rank of each chunk's first entry, so rank, offset
+// and timestamp-window lookups are two binary searches.
+//
+// The chunks hold only timestamps and event ids; each entry's fields live
+// once in events, in arrival order. Those events are also linked into one
+// list per flight in timestamp order. Flight IDs are interned in a pool of
+// their own, so a flight's id indexes histories directly and airports and
+// statuses take no history slots. One flight's history costs a hash lookup
+// plus O(k) for its k entries instead of a scan of the whole log. Entries
+// normally arrive in order and go on the tail; a late one walks its
+// flight's list to find its place.
+class FlightLog {
+private:
+    AircraftStore& store;
+    StringPool flightIDs;   // flight ID -> its histories index
+    StringPool strings;     // airports and statuses
+    DynamicArray<LogChunk*> chunks;
+    DynamicArray<int> chunkStart;
+    DynamicArray<LogEvent> events;
+    DynamicArray<FlightHistory> histories;  // by flightIDs id
+    int count;
+
+    LogChunk* appendChunk();
+    void splitChunk(int chunk);
+    int findChunk(int timestamp) const;
+    int locate(int rank) const;
+    int countBelow(long long bound) const;
+    void linkHistory(int flight, int id);
+
+    friend class LogCursor;
+    friend class HistoryCursor;
+
+public:
+    FlightLog(AircraftStore& store);
+    ~FlightLog();
+    FlightLog(const FlightLog&) = delete;
+    FlightLog& operator=(const FlightLog&) = delete;
+
+    void reserve(int entries);
+    void insert(int timestamp, const char* flightID, const char* origin,
+        const char* destination, const char* status);
+    void insert(int handle, int timestamp, const char* status);
+    void insert(const Aircraft& aircraft, const char* status);
+    void printLog() const;
+    void saveToFile(const char* filename) const;
+    void loadFromFile(const char* filename);
+    static void readRecord(const RecordReader& reader, Aircraft& aircraft, char* status, int statusSize);
+    bool isEmpty() const;
+    int getCount() const;
+    long long getMemoryBytes() const;
+
+    int countBefore(int timestamp) const;
+    int countRange(int from, int to) const;
+    LogCursor range(int from, int to) const;
+    LogCursor fromRank(int rank, int limit) const;
+
+    int countFlight(const char* flightID) const;
+    HistoryCursor history(const char* flightID) const;
+};
+
+#endif
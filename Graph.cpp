@@ -1,56 +1,94 @@
 #include "Graph.h"
 #include "Exceptions.h"
 #include "Colors.h"
+#include "Metrics.h"
+#include "RecordReader.h"
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <cstring>
+#include <cmath>
+#include <cstdlib>
 
 using namespace std;
 
-EdgeNode::EdgeNode(int d, int w) : dest(d), weight(w), next(nullptr) {}
+// Entry of the Dijkstra frontier heap. Ties on distance go to the lower node
+// index, which matches the order the old linear scan visited nodes in.
+struct DistEntry {
+    int dist;
+    int node;
+};
 
-Graph::Graph() : nodeCount(0) {
-    for (int i = 0; i < MAX_NODES; i++) {
-        adjList[i] = nullptr;
-        nodeNames[i][0] = '\0';
-        nodeX[i] = nodeY[i] = 0;
-        isAirport[i] = false;
+static bool distLess(const DistEntry& a, const DistEntry& b) {
+    return a.dist < b.dist || (a.dist == b.dist && a.node < b.node);
+}
+
+static void pushDist(DynamicArray<DistEntry>& heap, int dist, int node) {
+    DistEntry entry;
+    entry.dist = dist;
+    entry.node = node;
+    heap.pushBack(entry);
+
+    int i = heap.getSize() - 1;
+    while (i > 0 && distLess(heap[i], heap[(i - 1) / 2])) {
+        DistEntry t = heap[i];
+        heap[i] = heap[(i - 1) / 2];
+        heap[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
     }
 }
 
-Graph::~Graph() {
-    for (int i = 0; i < MAX_NODES; i++) {
-        EdgeNode* current = adjList[i];
-        while (current) {
-            EdgeNode* temp = current;
-            current = current->next;
-            delete temp;
-        }
+static DistEntry popDist(DynamicArray<DistEntry>& heap) {
+    DistEntry top = heap[0];
+    heap[0] = heap.back();
+    heap.popBack();
+
+    int size = heap.getSize();
+    int i = 0;
+    while (true) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < size && distLess(heap[left], heap[smallest])) smallest = left;
+        if (right < size && distLess(heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) break;
+        DistEntry t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
     }
+    return top;
 }
 
+Graph::Graph() : nodeCount(0), width(GRID_SIZE), height(GRID_SIZE), csrDirty(true), heuristicScale(0.0), airportTableDirty(true) {}
+
 bool Graph::isValidNode(int nodeID) const {
     return nodeID >= 0 && nodeID < nodeCount;
 }
 
 int Graph::addNode(const char* name, int x, int y, bool airport) {
-    if (nodeCount >= MAX_NODES) {
-        throw NodeFullException();
-    }
     if (name == nullptr || strlen(name) == 0) {
         throw InvalidInputException("Node name cannot be empty");
     }
     if (strlen(name) >= 20) {
         throw InvalidInputException("Node name too long");
     }
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) {
+    if (x < 0 || y < 0) {
         throw OutOfRangeException("Node coordinates");
     }
 
-    strcpy_s(nodeNames[nodeCount], 20, name);
-    nodeX[nodeCount] = x;
-    nodeY[nodeCount] = y;
-    isAirport[nodeCount] = airport;
+    GraphNode node;
+    strcpy_s(node.name, 20, name);
+    node.x = x;
+    node.y = y;
+    node.isAirport = airport;
+    nodes.pushBack(node);
+    csrDirty = true;
+    airportTableDirty = true;
+
+    // The airspace grows to cover every node; GRID_SIZE is only the minimum.
+    if (x >= width) width = x + 1;
+    if (y >= height) height = y + 1;
     return nodeCount++;
 }
 
@@ -62,42 +100,115 @@ void Graph::addEdge(int src, int dest, int weight) {
         throw OutOfRangeException("Edge weight");
     }
 
-    EdgeNode* newNode = new(nothrow) EdgeNode(dest, weight);
-    if (newNode == nullptr) {
-        throw MemoryAllocationException();
+    GraphEdge edge;
+    edge.src = src;
+    edge.dest = dest;
+    edge.weight = weight;
+    edges.pushBack(edge);
+    csrDirty = true;
+    airportTableDirty = true;
+}
+
+// Counting sort of the edge list by source node. Edges of one node are laid
+// out newest first, the same order the old linked adjacency lists used.
+void Graph::buildCSR() const {
+    METRIC_COUNT(CTR_CSR_REBUILDS);
+    int edgeCount = edges.getSize();
+
+    csrOffsets.clear();
+    csrOffsets.resize(nodeCount + 1, 0);
+    for (int i = 0; i < edgeCount; i++) {
+        csrOffsets[edges[i].src + 1]++;
+    }
+    for (int u = 0; u < nodeCount; u++) {
+        csrOffsets[u + 1] += csrOffsets[u];
+    }
+
+    DynamicArray<int> cursor(csrOffsets);
+    csrTargets.clear();
+    csrTargets.resize(edgeCount, 0);
+    csrWeights.clear();
+    csrWeights.resize(edgeCount, 0);
+    for (int i = edgeCount - 1; i >= 0; i--) {
+        int slot = cursor[edges[i].src]++;
+        csrTargets[slot] = edges[i].dest;
+        csrWeights[slot] = edges[i].weight;
+    }
+
+    revOffsets.clear();
+    revOffsets.resize(nodeCount + 1, 0);
+    for (int i = 0; i < edgeCount; i++) {
+        revOffsets[edges[i].dest + 1]++;
+    }
+    for (int u = 0; u < nodeCount; u++) {
+        revOffsets[u + 1] += revOffsets[u];
+    }
+
+    cursor = revOffsets;
+    revSources.clear();
+    revSources.resize(edgeCount, 0);
+    revWeights.clear();
+    revWeights.resize(edgeCount, 0);
+    for (int i = edgeCount - 1; i >= 0; i--) {
+        int slot = cursor[edges[i].dest]++;
+        revSources[slot] = edges[i].src;
+        revWeights[slot] = edges[i].weight;
+    }
+
+    heuristicScale = -1.0;
+    for (int i = 0; i < edgeCount; i++) {
+        double dx = nodes[edges[i].src].x - nodes[edges[i].dest].x;
+        double dy = nodes[edges[i].src].y - nodes[edges[i].dest].y;
+        double length = sqrt(dx * dx + dy * dy);
+        if (length > 0.0) {
+            double ratio = edges[i].weight / length;
+            if (heuristicScale < 0.0 || ratio < heuristicScale) {
+                heuristicScale = ratio;
+            }
+        }
+    }
+    if (heuristicScale < 0.0) heuristicScale = 0.0;
+
+    csrDirty = false;
+}
+
+void Graph::ensureCSR() const {
+    if (csrDirty) {
+        buildCSR();
     }
-    newNode->next = adjList[src];
-    adjList[src] = newNode;
 }
 
 int Graph::getNodeCount() const { return nodeCount; }
+int Graph::getEdgeCount() const { return edges.getSize(); }
+int Graph::getWidth() const { return width; }
+int Graph::getHeight() const { return height; }
 
 const char* Graph::getNodeName(int i) const {
     if (!isValidNode(i)) {
         throw InvalidNodeException(i);
     }
-    return nodeNames[i];
+    return nodes[i].name;
 }
 
 int Graph::getNodeX(int i) const {
     if (!isValidNode(i)) {
         throw InvalidNodeException(i);
     }
-    return nodeX[i];
+    return nodes[i].x;
 }
 
 int Graph::getNodeY(int i) const {
     if (!isValidNode(i)) {
         throw InvalidNodeException(i);
     }
-    return nodeY[i];
+    return nodes[i].y;
 }
 
 bool Graph::getIsAirport(int i) const {
     if (!isValidNode(i)) {
         throw InvalidNodeException(i);
     }
-    return isAirport[i];
+    return nodes[i].isAirport;
 }
 
 int Graph::findNode(const char* name) const {
@@ -105,25 +216,63 @@ int Graph::findNode(const char* name) const {
         return -1;
     }
     for (int i = 0; i < nodeCount; i++) {
-        if (strcmp(nodeNames[i], name) == 0) return i;
+        if (strcmp(nodes[i].name, name) == 0) return i;
     }
     return -1;
 }
 
-void Graph::dijkstra(int src, int dist[], int parent[]) const {
+// Binary-heap Dijkstra over the CSR layout, O(E log V). Stale heap entries
+// are skipped on pop instead of being decreased in place.
+void Graph::dijkstra(int src, DynamicArray<int>& dist, DynamicArray<int>& parent) const {
+    METRIC_TIMER(OP_DIJKSTRA);
     if (!isValidNode(src)) {
         throw InvalidNodeException(src);
     }
-    if (dist == nullptr || parent == nullptr) {
-        throw InvalidInputException("Null arrays provided to dijkstra");
-    }
+    ensureCSR();
+
+    DynamicArray<bool> visited;
+    visited.resize(nodeCount, false);
+    dist.clear();
+    dist.resize(nodeCount, INF);
+    parent.clear();
+    parent.resize(nodeCount, -1);
+    dist[src] = 0;
 
-    bool visited[MAX_NODES] = { false };
+    DynamicArray<DistEntry> frontier;
+    pushDist(frontier, 0, src);
 
-    for (int i = 0; i < nodeCount; i++) {
-        dist[i] = INF;
-        parent[i] = -1;
+    while (!frontier.isEmpty()) {
+        DistEntry top = popDist(frontier);
+        int u = top.node;
+        if (visited[u] || top.dist != dist[u]) continue;
+        visited[u] = true;
+
+        for (int e = csrOffsets[u]; e < csrOffsets[u + 1]; e++) {
+            int v = csrTargets[e];
+            int w = csrWeights[e];
+            if (!visited[v] && dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                parent[v] = u;
+                pushDist(frontier, dist[v], v);
+            }
+        }
+    }
+}
+
+// Original O(V^2) selection-scan Dijkstra, kept as the reference the heap
+// version is checked and benchmarked against.
+void Graph::dijkstraLinearScan(int src, DynamicArray<int>& dist, DynamicArray<int>& parent) const {
+    if (!isValidNode(src)) {
+        throw InvalidNodeException(src);
     }
+    ensureCSR();
+
+    DynamicArray<bool> visited;
+    visited.resize(nodeCount, false);
+    dist.clear();
+    dist.resize(nodeCount, INF);
+    parent.clear();
+    parent.resize(nodeCount, -1);
     dist[src] = 0;
 
     for (int i = 0; i < nodeCount; i++) {
@@ -138,55 +287,330 @@ void Graph::dijkstra(int src, int dist[], int parent[]) const {
         if (u == -1) break;
         visited[u] = true;
 
-        EdgeNode* edge = adjList[u];
-        while (edge) {
-            int v = edge->dest;
-            int w = edge->weight;
-            if (!visited[v] && dist[u] != INF && dist[u] + w < dist[v]) {
+        for (int e = csrOffsets[u]; e < csrOffsets[u + 1]; e++) {
+            int v = csrTargets[e];
+            int w = csrWeights[e];
+            if (!visited[v] && dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
                 parent[v] = u;
             }
-            edge = edge->next;
         }
     }
 }
 
-int Graph::findNearestAirport(int src, int path[], int& pathLen) const {
+// Dijkstra over reversed edges seeded with every node in targets at
+// distance 0. When node v is settled through edge v -> u, u is the next hop
+// from v toward its closest target; owner (if given) records which target
+// that is.
+void Graph::reverseSearch(const DynamicArray<int>& targets, DynamicArray<int>& dist,
+    DynamicArray<int>& nextHop, DynamicArray<int>* owner) const {
+    ensureCSR();
+
+    DynamicArray<bool> visited;
+    visited.resize(nodeCount, false);
+    dist.clear();
+    dist.resize(nodeCount, INF);
+    nextHop.clear();
+    nextHop.resize(nodeCount, -1);
+    if (owner != nullptr) {
+        owner->clear();
+        owner->resize(nodeCount, -1);
+    }
+
+    DynamicArray<DistEntry> frontier;
+    for (int i = 0; i < targets.getSize(); i++) {
+        int t = targets[i];
+        dist[t] = 0;
+        if (owner != nullptr) (*owner)[t] = t;
+        pushDist(frontier, 0, t);
+    }
+
+    while (!frontier.isEmpty()) {
+        DistEntry top = popDist(frontier);
+        int u = top.node;
+        if (visited[u] || top.dist != dist[u]) continue;
+        visited[u] = true;
+
+        for (int e = revOffsets[u]; e < revOffsets[u + 1]; e++) {
+            int v = revSources[e];
+            int w = revWeights[e];
+            if (!visited[v] && dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                if (owner != nullptr) (*owner)[v] = (*owner)[u];
+                nextHop[v] = u;
+                pushDist(frontier, dist[v], v);
+            }
+        }
+    }
+}
+
+// One reverse search seeded with every airport gives each node its nearest
+// airport, the distance to it and the next hop on that route.
+void Graph::buildNearestAirportTable() const {
+    DynamicArray<int> airports;
+    for (int i = 0; i < nodeCount; i++) {
+        if (nodes[i].isAirport) {
+            airports.pushBack(i);
+        }
+    }
+
+    reverseSearch(airports, airportDist, airportNextHop, &nearestAirport);
+    airportTableDirty = false;
+}
+
+// Shortest-path tree toward a single target: dist[v] is the cost from v to
+// target and nextHop[v] the first node after v on that route (-1 at the
+// target itself or when target is unreachable).
+void Graph::buildRouteTable(int target, DynamicArray<int>& dist, DynamicArray<int>& nextHop) const {
+    if (!isValidNode(target)) {
+        throw InvalidNodeException(target);
+    }
+
+    DynamicArray<int> targets;
+    targets.pushBack(target);
+    reverseSearch(targets, dist, nextHop, nullptr);
+}
+
+void Graph::ensureAirportTable() const {
+    if (airportTableDirty) {
+        buildNearestAirportTable();
+    }
+}
+
+int Graph::getNearestAirport(int node) const {
+    if (!isValidNode(node)) {
+        throw InvalidNodeException(node);
+    }
+    ensureAirportTable();
+    return nearestAirport[node];
+}
+
+int Graph::getNearestAirportDistance(int node) const {
+    if (!isValidNode(node)) {
+        throw InvalidNodeException(node);
+    }
+    ensureAirportTable();
+    return airportDist[node];
+}
+
+int Graph::getNearestAirportNextHop(int node) const {
+    if (!isValidNode(node)) {
+        throw InvalidNodeException(node);
+    }
+    ensureAirportTable();
+    return airportNextHop[node];
+}
+
+// Nearest airport other than src. For a node that is not itself an airport
+// the answer is read straight out of the table in O(path length); an
+// airport asking for a diversion still needs a full search from src.
+int Graph::findNearestAirport(int src, DynamicArray<int>& path) const {
     if (!isValidNode(src)) {
         throw InvalidNodeException(src);
     }
-    if (path == nullptr) {
-        throw InvalidInputException("Null path array");
+
+    path.clear();
+    if (!nodes[src].isAirport) {
+        ensureAirportTable();
+        int target = nearestAirport[src];
+        if (target == -1) {
+            return -1;
+        }
+        int curr = src;
+        while (curr != -1 && path.getSize() < nodeCount) {
+            path.pushBack(curr);
+            curr = airportNextHop[curr];
+        }
+        return target;
     }
 
-    int dist[MAX_NODES], parent[MAX_NODES];
+    DynamicArray<int> dist, parent;
     dijkstra(src, dist, parent);
 
-    int nearestAirport = -1;
+    int target = -1;
     int minDist = INF;
 
     for (int i = 0; i < nodeCount; i++) {
-        if (isAirport[i] && i != src && dist[i] < minDist) {
+        if (nodes[i].isAirport && i != src && dist[i] < minDist) {
             minDist = dist[i];
-            nearestAirport = i;
+            target = i;
         }
     }
 
-    pathLen = 0;
-    if (nearestAirport != -1) {
-        int temp[MAX_NODES];
-        int tempLen = 0;
-        int curr = nearestAirport;
-        while (curr != -1 && tempLen < MAX_NODES) {
-            temp[tempLen++] = curr;
+    if (target != -1) {
+        DynamicArray<int> temp;
+        int curr = target;
+        while (curr != -1 && temp.getSize() < nodeCount) {
+            temp.pushBack(curr);
             curr = parent[curr];
         }
-        for (int i = tempLen - 1; i >= 0; i--) {
-            path[pathLen++] = temp[i];
+        for (int i = temp.getSize() - 1; i >= 0; i--) {
+            path.pushBack(temp[i]);
+        }
+    }
+
+    return target;
+}
+
+// Straight-line distance to target times heuristicScale, rounded down. No
+// edge is cheaper than its own straight-line length times the scale, so the
+// estimate never exceeds the true remaining cost and stays consistent.
+int Graph::heuristic(int node, int target) const {
+    double dx = nodes[node].x - nodes[target].x;
+    double dy = nodes[node].y - nodes[target].y;
+    return (int)floor(heuristicScale * sqrt(dx * dx + dy * dy));
+}
+
+int Graph::aStarRoute(int src, int dst, bool useHeuristic, DynamicArray<int>& path, int& expanded) const {
+    DynamicArray<int> dist, parent;
+    DynamicArray<bool> closed;
+    dist.resize(nodeCount, INF);
+    parent.resize(nodeCount, -1);
+    closed.resize(nodeCount, false);
+
+    DynamicArray<DistEntry> open;
+    dist[src] = 0;
+    pushDist(open, useHeuristic ? heuristic(src, dst) : 0, src);
+
+    while (!open.isEmpty()) {
+        DistEntry top = popDist(open);
+        int u = top.node;
+        if (closed[u]) continue;
+        closed[u] = true;
+        expanded++;
+        if (u == dst) break;
+
+        for (int e = csrOffsets[u]; e < csrOffsets[u + 1]; e++) {
+            int v = csrTargets[e];
+            int candidate = dist[u] + csrWeights[e];
+            if (!closed[v] && candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                pushDist(open, candidate + (useHeuristic ? heuristic(v, dst) : 0), v);
+            }
         }
     }
 
-    return nearestAirport;
+    if (dist[dst] == INF) {
+        return -1;
+    }
+
+    DynamicArray<int> reversed;
+    for (int curr = dst; curr != -1; curr = parent[curr]) {
+        reversed.pushBack(curr);
+    }
+    for (int i = reversed.getSize() - 1; i >= 0; i--) {
+        path.pushBack(reversed[i]);
+    }
+    return dist[dst];
+}
+
+// Forward search over csr*, backward search over rev*. Always advances the
+// side with the smaller frontier key and stops once the two keys together
+// can no longer beat the best meeting point found so far.
+int Graph::bidirectionalRoute(int src, int dst, DynamicArray<int>& path, int& expanded) const {
+    DynamicArray<int> distF, distB, parentF, parentB;
+    DynamicArray<bool> doneF, doneB;
+    distF.resize(nodeCount, INF);
+    distB.resize(nodeCount, INF);
+    parentF.resize(nodeCount, -1);
+    parentB.resize(nodeCount, -1);
+    doneF.resize(nodeCount, false);
+    doneB.resize(nodeCount, false);
+
+    DynamicArray<DistEntry> openF, openB;
+    distF[src] = 0;
+    distB[dst] = 0;
+    pushDist(openF, 0, src);
+    pushDist(openB, 0, dst);
+
+    int best = INF;
+    int meet = src == dst ? src : -1;
+    if (src == dst) best = 0;
+
+    while (!openF.isEmpty() && !openB.isEmpty()) {
+        if (openF[0].dist + openB[0].dist >= best) break;
+
+        bool forward = openF[0].dist <= openB[0].dist;
+        DynamicArray<DistEntry>& open = forward ? openF : openB;
+        DynamicArray<int>& dist = forward ? distF : distB;
+        DynamicArray<int>& parent = forward ? parentF : parentB;
+        DynamicArray<bool>& done = forward ? doneF : doneB;
+        const DynamicArray<int>& otherDist = forward ? distB : distF;
+        const DynamicArray<int>& offsets = forward ? csrOffsets : revOffsets;
+        const DynamicArray<int>& targets = forward ? csrTargets : revSources;
+        const DynamicArray<int>& weights = forward ? csrWeights : revWeights;
+
+        DistEntry top = popDist(open);
+        int u = top.node;
+        if (done[u] || top.dist != dist[u]) continue;
+        done[u] = true;
+        expanded++;
+
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = targets[e];
+            int candidate = dist[u] + weights[e];
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                pushDist(open, candidate, v);
+            }
+            if (otherDist[v] != INF && candidate + otherDist[v] < best) {
+                best = candidate + otherDist[v];
+                meet = v;
+            }
+        }
+    }
+
+    if (meet == -1) {
+        return -1;
+    }
+
+    DynamicArray<int> reversed;
+    for (int curr = meet; curr != -1; curr = parentF[curr]) {
+        reversed.pushBack(curr);
+    }
+    for (int i = reversed.getSize() - 1; i >= 0; i--) {
+        path.pushBack(reversed[i]);
+    }
+    for (int curr = parentB[meet]; curr != -1; curr = parentB[curr]) {
+        path.pushBack(curr);
+    }
+    return best;
+}
+
+// Point-to-point route from src to dst. Returns the route cost, or -1 when
+// dst is unreachable. expanded, if given, receives the number of nodes the
+// search settled.
+int Graph::findRoute(int src, int dst, DynamicArray<int>& path, RouteAlgorithm algorithm, int* expanded) const {
+    METRIC_TIMER(OP_FIND_ROUTE);
+    if (!isValidNode(src)) {
+        throw InvalidNodeException(src);
+    }
+    if (!isValidNode(dst)) {
+        throw InvalidNodeException(dst);
+    }
+    ensureCSR();
+
+    path.clear();
+    int settled = 0;
+    int cost;
+    switch (algorithm) {
+    case ROUTE_BIDIRECTIONAL:
+        cost = bidirectionalRoute(src, dst, path, settled);
+        break;
+    case ROUTE_DIJKSTRA:
+        cost = aStarRoute(src, dst, false, path, settled);
+        break;
+    default:
+        cost = aStarRoute(src, dst, true, path, settled);
+        break;
+    }
+
+    if (expanded != nullptr) {
+        *expanded = settled;
+    }
+    return cost;
 }
 
 void Graph::displayNodes() const {
@@ -206,11 +630,11 @@ void Graph::displayNodes() const {
         setColor(3);
         cout << " | ";
         setColor(11); 
-        cout << left << setw(8) << nodeNames[i];
+        cout << left << setw(8) << nodes[i].name;
         setColor(3);
         cout << " | ";
 
-        if (isAirport[i]) {
+        if (nodes[i].isAirport) {
             setColor(10); 
             cout << left << setw(8) << "AIRPORT";
         }
@@ -222,7 +646,7 @@ void Graph::displayNodes() const {
         setColor(3);
         cout << " | ";
         setColor(13); 
-        cout << "(" << setw(2) << nodeX[i] << "," << setw(2) << nodeY[i] << ")";
+        cout << "(" << setw(2) << nodes[i].x << "," << setw(2) << nodes[i].y << ")";
         setColor(3);
         cout << "  |" << endl;
     }
@@ -231,3 +655,86 @@ void Graph::displayNodes() const {
     cout << "  +------+----------+----------+----------+" << endl;
     setColor(15);
 }
+
+// Airspace file: one record per line, pipe-delimited like the other data
+// files.
+//   NODE|name|x|y|isAirport
+//   EDGE|src|dest|weight
+// Edges refer to nodes by their position in the file. Lines starting with
+// '#' are comments.
+void Graph::saveToFile(const char* filename) const {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw FileException(filename);
+    }
+
+    for (int i = 0; i < nodeCount; i++) {
+        file << "NODE|" << nodes[i].name << "|" << nodes[i].x << "|" << nodes[i].y << "|"
+            << nodes[i].isAirport << "\n";
+    }
+    for (int i = 0; i < edges.getSize(); i++) {
+        file << "EDGE|" << edges[i].src << "|" << edges[i].dest << "|" << edges[i].weight << "\n";
+    }
+
+    file.close();
+    if (file.fail()) {
+        throw FileException(filename);
+    }
+}
+
+// Appends the file's nodes and edges to the graph. Unlike the flight files,
+// a missing or empty airspace file is an error: there is nothing sensible to
+// fly in. Every field is validated before anything reaches the CSR arrays;
+// a malformed record throws ParseException (a FileException) with its line
+// number, and the records before it stay loaded.
+void Graph::loadFromFile(const char* filename) {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    RecordReader reader;
+    if (!reader.open(filename)) {
+        throw FileException(filename);
+    }
+
+    int base = nodeCount;
+    while (reader.next()) {
+        if (reader.isComment()) continue;
+
+        char kind[8];
+        reader.readText(0, kind, sizeof(kind), "record type", true);
+        if (strcmp(kind, "NODE") == 0) {
+            reader.expectFields(5);
+            char name[20];
+            reader.readText(1, name, sizeof(name), "node name", true);
+            int x = reader.readInt(2, "x");
+            int y = reader.readInt(3, "y");
+            bool airport = reader.readFlag(4, "isAirport");
+            if (x < 0 || y < 0) {
+                reader.fail("negative node coordinates");
+            }
+            addNode(name, x, y, airport);
+        }
+        else if (strcmp(kind, "EDGE") == 0) {
+            reader.expectFields(4);
+            int src = reader.readInt(1, "source node");
+            int dest = reader.readInt(2, "destination node");
+            int weight = reader.readInt(3, "weight");
+            int loaded = nodeCount - base;
+            if (src < 0 || src >= loaded || dest < 0 || dest >= loaded) {
+                reader.fail("edge refers to a node not defined above it");
+            }
+            if (weight < 0) {
+                reader.fail("negative edge weight");
+            }
+            addEdge(base + src, base + dest, weight);
+        }
+        else {
+            reader.fail("unknown record type (NODE or EDGE)");
+        }
+    }
+}
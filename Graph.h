@@ -2,37 +2,90 @@
 #define GRAPH_H
 
 #include "Constants.h"
+#include "DynamicArray.h"
 
-struct EdgeNode {
+struct GraphEdge {
+    int src;
     int dest;
     int weight;
-    EdgeNode* next;
+};
+
+enum RouteAlgorithm {
+    ROUTE_DIJKSTRA,         // early-exit Dijkstra, no heuristic
+    ROUTE_ASTAR,            // A* with a scaled Euclidean heuristic
+    ROUTE_BIDIRECTIONAL     // Dijkstra from both ends, meeting in the middle
+};
 
-    EdgeNode(int d, int w);
+struct GraphNode {
+    char name[20];
+    int x, y;
+    bool isAirport;
 };
 
 class Graph {
 private:
-    EdgeNode* adjList[MAX_NODES];
-    char nodeNames[MAX_NODES][20];
-    int nodeX[MAX_NODES];
-    int nodeY[MAX_NODES];
-    bool isAirport[MAX_NODES];
+    DynamicArray<GraphEdge> edges;
+    DynamicArray<GraphNode> nodes;
     int nodeCount;
+    int width, height;
+
+    // Compressed-sparse-row copy of edges: the out-edges of node u are
+    // csrTargets/csrWeights[csrOffsets[u] .. csrOffsets[u + 1]). Rebuilt
+    // lazily after the graph changes.
+    mutable DynamicArray<int> csrOffsets;
+    mutable DynamicArray<int> csrTargets;
+    mutable DynamicArray<int> csrWeights;
+    // Same edges grouped by destination, for searches over reversed edges.
+    mutable DynamicArray<int> revOffsets;
+    mutable DynamicArray<int> revSources;
+    mutable DynamicArray<int> revWeights;
+    mutable bool csrDirty;
+    // Smallest weight per unit of grid distance over all edges. Scaling the
+    // straight-line distance by it keeps the A* heuristic admissible.
+    mutable double heuristicScale;
+
+    // Nearest-airport table from one multi-source Dijkstra over reversed
+    // edges: for every node, its closest airport, the distance to it and the
+    // next node on that route. Rebuilt lazily after the graph changes.
+    mutable DynamicArray<int> nearestAirport;
+    mutable DynamicArray<int> airportDist;
+    mutable DynamicArray<int> airportNextHop;
+    mutable bool airportTableDirty;
+
+    void ensureCSR() const;
+    void ensureAirportTable() const;
+    void reverseSearch(const DynamicArray<int>& targets, DynamicArray<int>& dist,
+        DynamicArray<int>& nextHop, DynamicArray<int>* owner) const;
+    int heuristic(int node, int target) const;
+    int aStarRoute(int src, int dst, bool useHeuristic, DynamicArray<int>& path, int& expanded) const;
+    int bidirectionalRoute(int src, int dst, DynamicArray<int>& path, int& expanded) const;
 
 public:
     Graph();
-    ~Graph();
     int addNode(const char* name, int x, int y, bool airport);
     void addEdge(int src, int dest, int weight);
     int getNodeCount() const;
+    int getEdgeCount() const;
+    int getWidth() const;
+    int getHeight() const;
     const char* getNodeName(int i) const;
     int getNodeX(int i) const;
     int getNodeY(int i) const;
     bool getIsAirport(int i) const;
     int findNode(const char* name) const;
-    void dijkstra(int src, int dist[], int parent[]) const;
-    int findNearestAirport(int src, int path[], int& pathLen) const;
+    void buildCSR() const;
+    void dijkstra(int src, DynamicArray<int>& dist, DynamicArray<int>& parent) const;
+    void dijkstraLinearScan(int src, DynamicArray<int>& dist, DynamicArray<int>& parent) const;
+    void buildNearestAirportTable() const;
+    void buildRouteTable(int target, DynamicArray<int>& dist, DynamicArray<int>& nextHop) const;
+    int getNearestAirport(int node) const;
+    int getNearestAirportDistance(int node) const;
+    int getNearestAirportNextHop(int node) const;
+    int findNearestAirport(int src, DynamicArray<int>& path) const;
+    int findRoute(int src, int dst, DynamicArray<int>& path,
+        RouteAlgorithm algorithm = ROUTE_ASTAR, int* expanded = nullptr) const;
+    void saveToFile(const char* filename) const;
+    void loadFromFile(const char* filename);
     void displayNodes() const;
     bool isValidNode(int nodeID) const;
 };
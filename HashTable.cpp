@@ -1,5 +1,8 @@
 #include "HashTable.h"
 #include "Exceptions.h"
+#include "Hashing.h"
+#include "Metrics.h"
+#include "RecordReader.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
@@ -7,41 +10,133 @@
 
 using namespace std;
 
-HashNode::HashNode(const Aircraft& a) : aircraft(a), next(nullptr) {}
-
-int HashTable::hashFunction(const char* key) {
+unsigned int HashTable::hashFunction(const char* key) const {
     if (key == nullptr) {
         throw InvalidInputException("Null key provided to hash function");
     }
-    int sum = 0;
-    for (int i = 0; key[i]; i++) {
-        sum += (int)key[i];
-    }
-    return sum % HASH_TABLE_SIZE;
+    return hashFlightID(key);
 }
 
-HashTable::HashTable() {
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        table[i] = nullptr;
+HashTable::HashTable(AircraftStore& store)
+    : table(nullptr), capacity(HASH_TABLE_INITIAL_CAPACITY), count(0), store(store) {
+    table = new HashSlot[capacity];
+    for (int i = 0; i < capacity; i++) {
+        table[i].handle = -1;
+        table[i].hash = 0;
+        table[i].distance = -1;
     }
 }
 
 HashTable::~HashTable() {
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        HashNode* current = table[i];
-        while (current) {
-            HashNode* temp = current;
-            current = current->next;
-            delete temp;
+    for (int i = 0; i < capacity; i++) {
+        if (table[i].distance != -1) {
+            store.release(table[i].handle);
+        }
+    }
+    delete[] table;
+}
+
+int HashTable::getCount() const { return count; }
+
+int HashTable::getHandleLimit() const { return store.getHandleLimit(); }
+
+Aircraft HashTable::get(int handle) const {
+    return store.get(handle);
+}
+
+AircraftStore& HashTable::getStore() { return store; }
+
+const AircraftStore& HashTable::getStore() const { return store; }
+
+int HashTable::findSlot(const char* flightID) const {
+    unsigned int h = hashFunction(flightID);
+    int mask = capacity - 1;
+    int index = (int)(h & mask);
+
+    // Robin Hood invariant: once we pass a slot whose entry is closer to its
+    // home than we are, the key cannot be further along.
+    for (int dist = 0; table[index].distance >= dist; dist++) {
+        if (table[index].hash == h && strcmp(store.flightID(table[index].handle), flightID) == 0) {
+            return index;
         }
+        index = (index + 1) & mask;
     }
+    return -1;
 }
 
-bool HashTable::exists(const char* flightID) {
-    return search(flightID) != nullptr;
+void HashTable::placeEntry(int handle, unsigned int hash) {
+    int mask = capacity - 1;
+    int index = (int)(hash & mask);
+    HashSlot entry;
+    entry.handle = handle;
+    entry.hash = hash;
+    entry.distance = 0;
+
+    while (table[index].distance != -1) {
+        if (table[index].distance < entry.distance) {
+            HashSlot displaced = table[index];
+            table[index] = entry;
+            entry = displaced;
+        }
+        index = (index + 1) & mask;
+        entry.distance++;
+    }
+    table[index] = entry;
+    count++;
 }
 
-void HashTable::insert(const Aircraft& aircraft) {
+void HashTable::resize(int newCapacity) {
+    METRIC_COUNT(CTR_REGISTRY_RESIZES);
+    HashSlot* oldTable = table;
+    int oldCapacity = capacity;
+
+    HashSlot* newTable = new(nothrow) HashSlot[newCapacity];
+    if (newTable == nullptr) {
+        throw MemoryAllocationException();
+    }
+    for (int i = 0; i < newCapacity; i++) {
+        newTable[i].handle = -1;
+        newTable[i].hash = 0;
+        newTable[i].distance = -1;
+    }
+
+    table = newTable;
+    capacity = newCapacity;
+    count = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldTable[i].distance != -1) {
+            placeEntry(oldTable[i].handle, oldTable[i].hash);
+        }
+    }
+    delete[] oldTable;
+}
+
+// Grows the slot table so that flightCount more entries stay under the
+// maximum load factor.
+void HashTable::reserveSlots(int flightCount) {
+    long long needed = (long long)count + flightCount;
+    int newCapacity = capacity;
+    while (needed * 100 > (long long)newCapacity * HASH_TABLE_MAX_LOAD_PERCENT) {
+        newCapacity *= 2;
+    }
+    if (newCapacity != capacity) {
+        resize(newCapacity);
+    }
+}
+
+// Grows the table and the record store so that flightCount more flights
+// can be inserted without a rehash, ahead of a bulk load.
+void HashTable::reserve(int flightCount) {
+    reserveSlots(flightCount);
+    store.reserve(store.getHandleLimit() + flightCount);
+    occupancy.reserve(store.getHandleLimit() + flightCount);
+}
+
+bool HashTable::exists(const char* flightID) const {
+    return findHandle(flightID) != -1;
+}
+
+int HashTable::insert(const Aircraft& aircraft) {
     try {
         if (strlen(aircraft.flightID) == 0) {
             throw InvalidFlightDataException("Cannot insert aircraft with empty flight ID");
@@ -51,36 +146,106 @@ void HashTable::insert(const Aircraft& aircraft) {
             throw DuplicateFlightException(aircraft.flightID);
         }
 
-        int index = hashFunction(aircraft.flightID);
-        HashNode* newNode = new(nothrow) HashNode(aircraft);
-
-        if (newNode == nullptr) {
-            throw MemoryAllocationException();
+        if ((long long)(count + 1) * 100 > (long long)capacity * HASH_TABLE_MAX_LOAD_PERCENT) {
+            resize(capacity * 2);
         }
 
-        newNode->next = table[index];
-        table[index] = newNode;
+        int handle = store.allocate(aircraft);
+        placeEntry(handle, hashFunction(aircraft.flightID));
+        if (aircraft.inAir) {
+            occupancy.insert(handle, aircraft.gridX, aircraft.gridY);
+        }
+        return handle;
     }
     catch (const bad_alloc&) {
         throw MemoryAllocationException();
     }
 }
 
-Aircraft* HashTable::search(const char* flightID) {
-    if (flightID == nullptr || strlen(flightID) == 0) {
-        return nullptr;
+// Registers the store records first..first+rangeCount-1 in bulk, taking
+// over the reference each one holds (see AircraftStore::allocateRange).
+// The registry must be empty and the flight IDs unique, as when a snapshot
+// is loaded on a cold start, so there is nothing to probe for.
+//
+// The entries are counting-sorted by home slot and laid out in one sweep:
+// placed in home order, each lands on the first free slot at or after its
+// home, which is already a valid Robin Hood table. Only entries that run
+// off the end and wrap around go through placeEntry. If the work arrays
+// cannot be allocated, the records are released and nothing is registered.
+void HashTable::adoptRange(int first, int rangeCount) {
+    if (count != 0) {
+        throw InvalidInputException("Bulk registration needs an empty registry");
+    }
+
+    DynamicArray<unsigned int> hashes;
+    DynamicArray<int> bucketEnd;
+    DynamicArray<int> order;
+    try {
+        reserveSlots(rangeCount);
+        hashes.resize(rangeCount);
+        bucketEnd.resize(capacity + 1, 0);
+        order.resize(rangeCount);
+    }
+    catch (...) {
+        for (int h = first; h < first + rangeCount; h++) {
+            store.release(h);
+        }
+        throw;
     }
 
-    int index = hashFunction(flightID);
-    HashNode* current = table[index];
+    int mask = capacity - 1;
+    for (int i = 0; i < rangeCount; i++) {
+        hashes[i] = hashFunction(store.flightID(first + i));
+        bucketEnd[(int)(hashes[i] & mask) + 1]++;
+    }
+    for (int slot = 0; slot < capacity; slot++) {
+        bucketEnd[slot + 1] += bucketEnd[slot];
+    }
+    for (int i = 0; i < rangeCount; i++) {
+        order[bucketEnd[hashes[i] & mask]++] = i;
+    }
 
-    while (current) {
-        if (strcmp(current->aircraft.flightID, flightID) == 0) {
-            return &(current->aircraft);
+    int nextFree = 0;
+    for (int k = 0; k < rangeCount; k++) {
+        int i = order[k];
+        int home = (int)(hashes[i] & mask);
+        int slot = home > nextFree ? home : nextFree;
+        if (slot >= capacity) {
+            placeEntry(first + i, hashes[i]);
+            continue;
         }
-        current = current->next;
+        table[slot].handle = first + i;
+        table[slot].hash = hashes[i];
+        table[slot].distance = slot - home;
+        nextFree = slot + 1;
+        count++;
+    }
+
+    // order is no longer needed; reuse it for the airborne handles.
+    order.clear();
+    for (int h = first; h < first + rangeCount; h++) {
+        if (store.inAir(h)) order.pushBack(h);
+    }
+    occupancy.insertAll(order, store.xData(), store.yData());
+}
+
+int HashTable::findHandle(const char* flightID) const {
+    if (flightID == nullptr || strlen(flightID) == 0) {
+        return -1;
+    }
+
+    int index = findSlot(flightID);
+    return index == -1 ? -1 : table[index].handle;
+}
+
+// Copies the record for flightID into aircraft; false when there is none.
+bool HashTable::search(const char* flightID, Aircraft& aircraft) const {
+    int handle = findHandle(flightID);
+    if (handle == -1) {
+        return false;
     }
-    return nullptr;
+    aircraft = store.get(handle);
+    return true;
 }
 
 bool HashTable::remove(const char* flightID) {
@@ -88,36 +253,70 @@ bool HashTable::remove(const char* flightID) {
         return false;
     }
 
-    int index = hashFunction(flightID);
-    HashNode* current = table[index];
-    HashNode* prev = nullptr;
+    int index = findSlot(flightID);
+    if (index == -1) {
+        return false;
+    }
 
-    while (current) {
-        if (strcmp(current->aircraft.flightID, flightID) == 0) {
-            if (prev) prev->next = current->next;
-            else table[index] = current->next;
-            delete current;
-            return true;
-        }
-        prev = current;
-        current = current->next;
+    occupancy.remove(table[index].handle);
+    store.release(table[index].handle);
+
+    // Backward-shift deletion keeps probe sequences intact without tombstones.
+    int mask = capacity - 1;
+    int next = (index + 1) & mask;
+    while (table[next].distance > 0) {
+        table[index] = table[next];
+        table[index].distance--;
+        index = next;
+        next = (next + 1) & mask;
     }
-    return false;
+    table[index].handle = -1;
+    table[index].hash = 0;
+    table[index].distance = -1;
+    count--;
+    return true;
 }
 
-void HashTable::getAllFlights(Aircraft* flights, int& count) {
-    if (flights == nullptr) {
-        throw InvalidInputException("Null array provided to getAllFlights");
+void HashTable::updatePosition(int handle, int graphNode, int x, int y) {
+    if (handle < 0 || handle >= store.getHandleLimit()) {
+        throw InvalidInputException("Invalid registry handle");
+    }
+    store.setPosition(handle, graphNode, x, y);
+    if (store.inAir(handle)) {
+        occupancy.move(handle, x, y);
     }
+}
 
-    count = 0;
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        HashNode* current = table[i];
-        while (current) {
-            if (current->aircraft.inAir && count < MAX_FLIGHTS) {
-                flights[count++] = current->aircraft;
-            }
-            current = current->next;
+void HashTable::markLanded(int handle) {
+    if (handle < 0 || handle >= store.getHandleLimit()) {
+        throw InvalidInputException("Invalid registry handle");
+    }
+    store.setInAir(handle, false);
+    occupancy.remove(handle);
+}
+
+// Handle of an airborne aircraft on (x, y) other than excludeHandle, or -1.
+int HashTable::findOccupant(int x, int y, int excludeHandle) const {
+    return occupancy.findAt(x, y, excludeHandle);
+}
+
+void HashTable::getAllFlights(DynamicArray<Aircraft>& flights) const {
+    flights.clear();
+    for (int i = 0; i < capacity; i++) {
+        if (table[i].distance == -1) continue;
+        if (store.inAir(table[i].handle)) {
+            flights.pushBack(store.get(table[i].handle));
+        }
+    }
+}
+
+// Handles of every registered flight, in no particular order.
+void HashTable::getHandles(DynamicArray<int>& handles) const {
+    handles.clear();
+    handles.reserve(count);
+    for (int i = 0; i < capacity; i++) {
+        if (table[i].distance != -1) {
+            handles.pushBack(table[i].handle);
         }
     }
 }
@@ -133,19 +332,16 @@ void HashTable::saveToFile(const char* filename) {
     }
 
     try {
-        for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-            HashNode* current = table[i];
-            while (current) {
-                Aircraft& a = current->aircraft;
-                file << a.flightID << "|" << a.model << "|" << a.fuelLevel << "|"
-                    << a.origin << "|" << a.destination << "|" << a.priority << "|"
-                    << a.gridX << "|" << a.gridY << "|" << a.graphNode << "|"
-                    << a.inAir << "|" << a.timestamp << endl;
-
-                if (file.fail()) {
-                    throw FileException(filename);
-                }
-                current = current->next;
+        for (int i = 0; i < capacity; i++) {
+            if (table[i].distance == -1) continue;
+            Aircraft a = store.get(table[i].handle);
+            file << a.flightID << "|" << a.model << "|" << a.fuelLevel << "|"
+                << a.origin << "|" << a.destination << "|" << a.priority << "|"
+                << a.gridX << "|" << a.gridY << "|" << a.graphNode << "|"
+                << a.inAir << "|" << a.timestamp << '\n';
+
+            if (file.fail()) {
+                throw FileException(filename);
             }
         }
         file.close();
@@ -156,61 +352,39 @@ void HashTable::saveToFile(const char* filename) {
     }
 }
 
+// Parses one flights.txt line (the saveToFile layout) into aircraft.
+void HashTable::readRecord(const RecordReader& reader, Aircraft& aircraft) {
+    reader.expectFields(11);
+    reader.readText(0, aircraft.flightID, sizeof(aircraft.flightID), "flight ID", true);
+    reader.readText(1, aircraft.model, sizeof(aircraft.model), "model", false);
+    aircraft.fuelLevel = reader.readInt(2, "fuel level");
+    reader.readText(3, aircraft.origin, sizeof(aircraft.origin), "origin", false);
+    reader.readText(4, aircraft.destination, sizeof(aircraft.destination), "destination", false);
+    aircraft.priority = reader.readInt(5, "priority");
+    aircraft.gridX = reader.readInt(6, "grid x");
+    aircraft.gridY = reader.readInt(7, "grid y");
+    aircraft.graphNode = reader.readInt(8, "graph node");
+    aircraft.inAir = reader.readFlag(9, "in-air flag");
+    aircraft.timestamp = reader.readInt(10, "timestamp");
+}
+
+// Flights already in the registry are skipped. A malformed line throws
+// ParseException; the lines before it stay loaded.
 void HashTable::loadFromFile(const char* filename) {
     if (filename == nullptr || strlen(filename) == 0) {
         throw FileException("Invalid filename");
     }
 
-    ifstream file(filename);
-    if (!file.is_open()) {
+    RecordReader reader;
+    if (!reader.open(filename)) {
         return;
     }
 
-    try {
-        char line[512];
-        while (file.getline(line, 512)) {
-            Aircraft a;
-            char tempLine[512];
-            strcpy_s(tempLine, 512, line);
-
-            char* context = nullptr;
-            char* token = strtok_s(tempLine, "|", &context);
-
-            if (token) strcpy_s(a.flightID, 20, token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) strcpy_s(a.model, 30, token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.fuelLevel = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) strcpy_s(a.origin, 20, token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) strcpy_s(a.destination, 20, token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.priority = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.gridX = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.gridY = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.graphNode = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.inAir = atoi(token);
-            token = strtok_s(nullptr, "|", &context);
-            if (token) a.timestamp = atoi(token);
-
-            if (strlen(a.flightID) > 0 && !exists(a.flightID)) {
-                int index = hashFunction(a.flightID);
-                HashNode* newNode = new(nothrow) HashNode(a);
-                if (newNode) {
-                    newNode->next = table[index];
-                    table[index] = newNode;
-                }
-            }
+    while (reader.next()) {
+        Aircraft a;
+        readRecord(reader, a);
+        if (!exists(a.flightID)) {
+            insert(a);
         }
-        file.close();
-    }
-    catch (...) {
-        file.close();
-        throw;
     }
 }
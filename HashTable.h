@@ -3,28 +3,65 @@
 
 #include "Constants.h"
 #include "Aircraft.h"
+#include "AircraftStore.h"
+#include "DynamicArray.h"
+#include "SpatialIndex.h"
+#include "RecordReader.h"
 
-struct HashNode {
-    Aircraft aircraft;
-    HashNode* next;
-    HashNode(const Aircraft& a);
+// Open-addressing slot (Robin Hood probing). distance is how far the entry
+// sits from its home slot; -1 marks an empty slot. handle refers to the
+// record in the AircraftStore.
+struct HashSlot {
+    int handle;
+    unsigned int hash;
+    int distance;
 };
 
 class HashTable {
 private:
-    HashNode* table[HASH_TABLE_SIZE];
-    int hashFunction(const char* key);
+    HashSlot* table;
+    int capacity;
+    int count;
+
+    // Flight ID index over the shared record store. The registry holds one
+    // reference on each record it indexes.
+    AircraftStore& store;
+
+    // Which airborne aircraft sits on each radar cell. Kept in step with
+    // insert, updatePosition, markLanded and remove.
+    SpatialIndex occupancy;
+
+    unsigned int hashFunction(const char* key) const;
+    int findSlot(const char* flightID) const;
+    void placeEntry(int handle, unsigned int hash);
+    void resize(int newCapacity);
+    void reserveSlots(int flightCount);
 
 public:
-    HashTable();
+    HashTable(AircraftStore& store);
     ~HashTable();
-    void insert(const Aircraft& aircraft);
-    Aircraft* search(const char* flightID);
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+    void reserve(int flightCount);
+    int insert(const Aircraft& aircraft);
+    void adoptRange(int first, int rangeCount);
+    bool search(const char* flightID, Aircraft& aircraft) const;
+    int findHandle(const char* flightID) const;
+    Aircraft get(int handle) const;
+    AircraftStore& getStore();
+    const AircraftStore& getStore() const;
     bool remove(const char* flightID);
-    void getAllFlights(Aircraft* flights, int& count);
+    void updatePosition(int handle, int graphNode, int x, int y);
+    void markLanded(int handle);
+    int findOccupant(int x, int y, int excludeHandle = -1) const;
+    void getAllFlights(DynamicArray<Aircraft>& flights) const;
+    void getHandles(DynamicArray<int>& handles) const;
     void saveToFile(const char* filename);
     void loadFromFile(const char* filename);
-    bool exists(const char* flightID);
+    static void readRecord(const RecordReader& reader, Aircraft& aircraft);
+    bool exists(const char* flightID) const;
+    int getCount() const;
+    int getHandleLimit() const;
 };
 
 #endif
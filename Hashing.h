@@ -0,0 +1,20 @@
+#ifndef HASHING_H
+#define HASHING_H
+
+// FNV-1a over the key followed by a murmur3 finalizer so that the low bits
+// used for slot selection depend on every character.
+inline unsigned int hashFlightID(const char* key) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; key[i]; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+#endif
@@ -0,0 +1,208 @@
+#include "Journal.h"
+#include "Exceptions.h"
+#include "RecordReader.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+Journal::Journal(const char* filename)
+    : filename(filename), pendingRecords(0), committedRecords(0), recording(false), generation(0) {}
+
+int Journal::getPendingCount() const { return pendingRecords; }
+
+int Journal::getCommittedCount() const { return committedRecords; }
+
+bool Journal::isRecording() const { return recording; }
+
+void Journal::append(const char* line) {
+    pending += line;
+    pending += '\n';
+    pendingRecords++;
+}
+
+void Journal::recordAdd(const Aircraft& a) {
+    if (!recording) return;
+    char line[256];
+    snprintf(line, sizeof(line), "ADD|%s|%s|%d|%s|%s|%d|%d|%d|%d|%d|%d",
+        a.flightID, a.model, a.fuelLevel, a.origin, a.destination, a.priority,
+        a.gridX, a.gridY, a.graphNode, a.inAir ? 1 : 0, a.timestamp);
+    append(line);
+}
+
+void Journal::recordMove(const char* flightID, int node, int x, int y, int fuel, int priority) {
+    if (!recording) return;
+    char line[128];
+    snprintf(line, sizeof(line), "MOVE|%s|%d|%d|%d|%d|%d", flightID, node, x, y, fuel, priority);
+    append(line);
+}
+
+void Journal::recordPriority(const char* flightID, int priority) {
+    if (!recording) return;
+    char line[64];
+    snprintf(line, sizeof(line), "PRIO|%s|%d", flightID, priority);
+    append(line);
+}
+
+void Journal::recordLanding(const char* flightID, int timestamp) {
+    if (!recording) return;
+    char line[64];
+    snprintf(line, sizeof(line), "LAND|%s|%d", flightID, timestamp);
+    append(line);
+}
+
+// Appends every pending record with a single write and flush.
+void Journal::commit() {
+    if (pendingRecords == 0) {
+        return;
+    }
+
+    ofstream file(filename.c_str(), ios::app | ios::binary);
+    if (!file.is_open()) {
+        throw FileException(filename.c_str());
+    }
+    // A journal created by this append (e.g. deleted since the load) still
+    // needs its generation line.
+    file.seekp(0, ios::end);
+    if (file.tellp() == 0) {
+        file << "GEN|" << generation << '\n';
+    }
+    file.write(pending.data(), (streamsize)pending.size());
+    file.flush();
+    if (file.fail()) {
+        throw FileException(filename.c_str());
+    }
+
+    committedRecords += pendingRecords;
+    pending.clear();
+    pendingRecords = 0;
+}
+
+// Empties the journal once a snapshot holds everything in it, tags it with
+// that snapshot's generation, and starts recording again.
+void Journal::reset(unsigned int snapshotGeneration) {
+    ofstream file(filename.c_str(), ios::trunc | ios::binary);
+    if (!file.is_open()) {
+        throw FileException(filename.c_str());
+    }
+    file << "GEN|" << snapshotGeneration << '\n';
+    file.close();
+    if (file.fail()) {
+        throw FileException(filename.c_str());
+    }
+    discardPending();
+    committedRecords = 0;
+    generation = snapshotGeneration;
+    recording = true;
+}
+
+void Journal::discardPending() {
+    pending.clear();
+    pendingRecords = 0;
+}
+
+// Stops buffering until the next snapshot; see the class comment.
+void Journal::suspend() {
+    discardPending();
+    recording = false;
+}
+
+// Records again on top of a journal that matches the snapshot just loaded.
+void Journal::resume(unsigned int snapshotGeneration) {
+    generation = snapshotGeneration;
+    recording = true;
+}
+
+// Generation on the journal file's GEN line; 0 when the file is missing or
+// has none (written before generations existed).
+unsigned int Journal::readGeneration() const {
+    RecordReader reader;
+    if (!reader.open(filename.c_str()) || !reader.next() || reader.getFieldCount() != 2) {
+        return 0;
+    }
+    char kind[8];
+    reader.readText(0, kind, sizeof(kind), "record type", true);
+    if (strcmp(kind, "GEN") != 0) {
+        return 0;
+    }
+    return (unsigned int)reader.readInt(1, "generation");
+}
+
+// Reads the committed records back for replay and the generation on the
+// GEN line (0 without one). Returns false when there is no journal. A last
+// line without its newline is the tail of an interrupted append and is
+// skipped; any other malformed line throws ParseException with its line
+// number.
+bool Journal::readRecords(DynamicArray<JournalRecord>& records, unsigned int& fileGeneration) {
+    records.clear();
+    committedRecords = 0;
+    fileGeneration = 0;
+
+    RecordReader reader;
+    if (!reader.open(filename.c_str())) {
+        return false;
+    }
+
+    while (reader.next()) {
+        if (!reader.isTerminated()) break;
+
+        char kind[8];
+        reader.readText(0, kind, sizeof(kind), "record type", true);
+        if (strcmp(kind, "GEN") == 0) {
+            if (reader.getLineNumber() != 1) {
+                reader.fail("GEN must be the first line");
+            }
+            reader.expectFields(2);
+            fileGeneration = (unsigned int)reader.readInt(1, "generation");
+            continue;
+        }
+
+        JournalRecord record;
+        if (strcmp(kind, "ADD") == 0) record.type = JOURNAL_ADD;
+        else if (strcmp(kind, "MOVE") == 0) record.type = JOURNAL_MOVE;
+        else if (strcmp(kind, "PRIO") == 0) record.type = JOURNAL_PRIORITY;
+        else if (strcmp(kind, "LAND") == 0) record.type = JOURNAL_LAND;
+        else reader.fail("unknown record type");
+
+        Aircraft& a = record.aircraft;
+        switch (record.type) {
+        case JOURNAL_ADD:
+            reader.expectFields(12);
+            reader.readText(1, a.flightID, sizeof(a.flightID), "flight ID", true);
+            reader.readText(2, a.model, sizeof(a.model), "model", false);
+            a.fuelLevel = reader.readInt(3, "fuel");
+            reader.readText(4, a.origin, sizeof(a.origin), "origin", false);
+            reader.readText(5, a.destination, sizeof(a.destination), "destination", false);
+            a.priority = reader.readInt(6, "priority");
+            a.gridX = reader.readInt(7, "x");
+            a.gridY = reader.readInt(8, "y");
+            a.graphNode = reader.readInt(9, "node");
+            a.inAir = reader.readFlag(10, "inAir");
+            a.timestamp = reader.readInt(11, "timestamp");
+            break;
+        case JOURNAL_MOVE:
+            reader.expectFields(7);
+            reader.readText(1, a.flightID, sizeof(a.flightID), "flight ID", true);
+            a.graphNode = reader.readInt(2, "node");
+            a.gridX = reader.readInt(3, "x");
+            a.gridY = reader.readInt(4, "y");
+            a.fuelLevel = reader.readInt(5, "fuel");
+            a.priority = reader.readInt(6, "priority");
+            break;
+        case JOURNAL_PRIORITY:
+            reader.expectFields(3);
+            reader.readText(1, a.flightID, sizeof(a.flightID), "flight ID", true);
+            a.priority = reader.readInt(2, "priority");
+            break;
+        case JOURNAL_LAND:
+            reader.expectFields(3);
+            reader.readText(1, a.flightID, sizeof(a.flightID), "flight ID", true);
+            a.timestamp = reader.readInt(2, "timestamp");
+            break;
+        }
+        records.pushBack(record);
+    }
+    committedRecords = records.getSize();
+    return true;
+}
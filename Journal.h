@@ -0,0 +1,70 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Constants.h"
+#include "Aircraft.h"
+#include "DynamicArray.h"
+#include <string>
+
+enum JournalRecordType {
+    JOURNAL_ADD,        // full record of a new flight
+    JOURNAL_MOVE,       // flightID, graphNode, gridX, gridY, fuelLevel, priority
+    JOURNAL_PRIORITY,   // flightID, priority
+    JOURNAL_LAND        // flightID, timestamp of the landing
+};
+
+// One replayed mutation. Only the fields listed for its type are meaningful.
+struct JournalRecord {
+    int type;
+    Aircraft aircraft;
+};
+
+// Append-only log of state mutations since the last snapshot. Records are
+// buffered in memory as they happen and written out together by commit()
+// (group commit): one append and one flush per save, whatever the number of
+// records. After a snapshot the file is truncated with reset(), which
+// starts it with a GEN line carrying the snapshot's generation. A journal
+// whose generation differs from the snapshot's is stale (its truncation
+// failed after a newer snapshot was written) and must not be replayed.
+//
+// Recording is suspended while the files on disk do not describe the
+// in-memory state (no snapshot yet this session, or a simulation tick or
+// text import since the last one). The next save writes a full snapshot
+// anyway, so records are dropped rather than buffered; reset() resumes.
+//
+// Every record holds absolute values and a current journal only holds
+// mutations made after its snapshot, so replaying it is idempotent. A torn
+// last line from an interrupted append is skipped on replay.
+class Journal {
+private:
+    std::string filename;
+    std::string pending;
+    int pendingRecords;
+    int committedRecords;
+    bool recording;
+    unsigned int generation;
+
+    void append(const char* line);
+
+public:
+    Journal(const char* filename);
+
+    void recordAdd(const Aircraft& aircraft);
+    void recordMove(const char* flightID, int node, int x, int y, int fuel, int priority);
+    void recordPriority(const char* flightID, int priority);
+    void recordLanding(const char* flightID, int timestamp);
+
+    void commit();
+    void reset(unsigned int snapshotGeneration);
+    void discardPending();
+    void suspend();
+    void resume(unsigned int snapshotGeneration);
+    bool isRecording() const;
+    bool readRecords(DynamicArray<JournalRecord>& records, unsigned int& fileGeneration);
+    unsigned int readGeneration() const;
+
+    int getPendingCount() const;
+    int getCommittedCount() const;
+};
+
+#endif
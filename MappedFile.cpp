@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), fileHandle(nullptr), mappingHandle(nullptr) {}
+
+void MappedFile::close() {
+    if (bytes != nullptr) UnmapViewOfFile(bytes);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != nullptr) CloseHandle(fileHandle);
+    bytes = nullptr;
+    length = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+// False when the file is missing, empty or cannot be mapped.
+bool MappedFile::open(const char* filename) {
+    close();
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+    bytes = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (bytes == nullptr) {
+        close();
+        return false;
+    }
+    length = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+#else
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), descriptor(-1) {}
+
+void MappedFile::close() {
+    if (bytes != nullptr) munmap((void*)bytes, length);
+    if (descriptor != -1) ::close(descriptor);
+    bytes = nullptr;
+    length = 0;
+    descriptor = -1;
+}
+
+// False when the file is missing, empty or cannot be mapped.
+bool MappedFile::open(const char* filename) {
+    close();
+    descriptor = ::open(filename, O_RDONLY);
+    if (descriptor == -1) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+    bytes = (const unsigned char*)mapped;
+    length = (size_t)info.st_size;
+    return true;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+const unsigned char* MappedFile::data() const { return bytes; }
+
+size_t MappedFile::size() const { return length; }
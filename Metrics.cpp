@@ -0,0 +1,229 @@
+#include "Metrics.h"
+#include <iomanip>
+
+using namespace std;
+
+// ------------------------------------------------------------ histogram
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) counts[i] = 0;
+    total = 0;
+    sum = 0;
+    minimum = 0;
+    maximum = 0;
+}
+
+int LatencyHistogram::bucketIndex(unsigned long long value) {
+    if (value < (unsigned long long)(2 * SUB_BUCKETS)) {
+        return (int)value;
+    }
+
+    int msb = 0;
+    unsigned long long v = value;
+    if (v >> 32) { v >>= 32; msb += 32; }
+    if (v >> 16) { v >>= 16; msb += 16; }
+    if (v >> 8) { v >>= 8; msb += 8; }
+    if (v >> 4) { v >>= 4; msb += 4; }
+    if (v >> 2) { v >>= 2; msb += 2; }
+    if (v >> 1) { msb += 1; }
+    if (msb > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+
+    // Keep the top SUB_BUCKET_BITS + 1 bits: the leading one plus the
+    // sub-bucket within this power of two.
+    int shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (int)(value >> shift) - SUB_BUCKETS;
+}
+
+unsigned long long LatencyHistogram::bucketUpperBound(int index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return (unsigned long long)index;
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    unsigned long long sub = (unsigned long long)(index % SUB_BUCKETS + SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(unsigned long long nanoseconds) {
+    counts[bucketIndex(nanoseconds)]++;
+    if (total == 0 || nanoseconds < minimum) minimum = nanoseconds;
+    if (nanoseconds > maximum) maximum = nanoseconds;
+    total++;
+    sum += nanoseconds;
+}
+
+unsigned long long LatencyHistogram::getCount() const { return total; }
+unsigned long long LatencyHistogram::getSum() const { return sum; }
+unsigned long long LatencyHistogram::getMin() const { return minimum; }
+unsigned long long LatencyHistogram::getMax() const { return maximum; }
+
+// Upper bound of the bucket holding the p-th percentile (0-100), capped at
+// the largest value actually recorded.
+unsigned long long LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0;
+
+    unsigned long long rank = (unsigned long long)(p / 100.0 * total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    unsigned long long seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            unsigned long long bound = bucketUpperBound(i);
+            return bound < maximum ? bound : maximum;
+        }
+    }
+    return maximum;
+}
+
+// Samples whose bucket lies entirely at or below the given value.
+unsigned long long LatencyHistogram::countAtOrBelow(unsigned long long nanoseconds) const {
+    unsigned long long seen = 0;
+    for (int i = 0; i < BUCKET_COUNT && bucketUpperBound(i) <= nanoseconds; i++) {
+        seen += counts[i];
+    }
+    return seen;
+}
+
+// -------------------------------------------------------------- metrics
+
+static const char* OPERATION_NAMES[OP_COUNT] = {
+    "add_flight", "move_flight", "declare_emergency", "land_flight", "find_safe_route",
+    "save_state", "load_state", "dijkstra", "find_route", "simulation_tick"
+};
+
+static const char* COUNTER_NAMES[CTR_COUNT] = {
+    "flights_added", "flights_landed", "collisions", "duplicate_flights", "heap_empty",
+    "low_fuel_upgrades", "registry_resizes", "csr_rebuilds", "journal_records", "snapshots"
+};
+
+// Operations that finish in well under a microsecond are sampled; searches
+// and file I/O are timed on every call.
+static const bool FAST_OPERATION[OP_COUNT] = {
+    true, true, true, true, true,
+    false, false, false, false, false
+};
+
+Metrics::Metrics() {
+    for (int i = 0; i < OP_COUNT; i++) {
+        sampleMask[i] = FAST_OPERATION[i] ? FAST_OP_SAMPLE_INTERVAL - 1 : 0;
+    }
+    reset();
+}
+
+Metrics& metrics() {
+    static Metrics instance;
+    return instance;
+}
+
+bool Metrics::isEnabled() {
+    return SKYNET_METRICS != 0;
+}
+
+const char* Metrics::operationName(MetricOperation op) {
+    return OPERATION_NAMES[op];
+}
+
+const char* Metrics::counterName(MetricCounter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+const LatencyHistogram& Metrics::getLatency(MetricOperation op) const {
+    return latencies[op];
+}
+
+unsigned long long Metrics::getCalls(MetricOperation op) const {
+    return calls[op];
+}
+
+unsigned long long Metrics::getCounter(MetricCounter counter) const {
+    return counters[counter];
+}
+
+void Metrics::reset() {
+    for (int i = 0; i < OP_COUNT; i++) {
+        latencies[i].reset();
+        calls[i] = 0;
+    }
+    for (int i = 0; i < CTR_COUNT; i++) counters[i] = 0;
+}
+
+static double microseconds(unsigned long long nanoseconds) {
+    return nanoseconds / 1000.0;
+}
+
+void Metrics::writeText(ostream& out) const {
+    if (!isEnabled()) {
+        out << "Metrics are compiled out of this build (SKYNET_METRICS=0)." << endl;
+        return;
+    }
+
+    ios::fmtflags savedFlags = out.flags();
+    streamsize savedPrecision = out.precision();
+
+    out << "Operation latency (microseconds)" << endl;
+    out << left << setw(20) << "operation" << right << setw(10) << "calls"
+        << setw(10) << "timed" << setw(11) << "min" << setw(11) << "p50" << setw(11) << "p90"
+        << setw(11) << "p99" << setw(11) << "p99.9" << setw(11) << "max" << endl;
+    out << fixed << setprecision(1);
+    for (int i = 0; i < OP_COUNT; i++) {
+        const LatencyHistogram& h = latencies[i];
+        if (h.getCount() == 0) continue;
+        out << left << setw(20) << OPERATION_NAMES[i] << right << setw(10) << calls[i]
+            << setw(10) << h.getCount()
+            << setw(11) << microseconds(h.getMin())
+            << setw(11) << microseconds(h.percentile(50))
+            << setw(11) << microseconds(h.percentile(90))
+            << setw(11) << microseconds(h.percentile(99))
+            << setw(11) << microseconds(h.percentile(99.9))
+            << setw(11) << microseconds(h.getMax()) << endl;
+    }
+
+    out << "\nEvents" << endl;
+    for (int i = 0; i < CTR_COUNT; i++) {
+        out << left << setw(20) << COUNTER_NAMES[i] << right << setw(10) << counters[i] << endl;
+    }
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
+
+// Prometheus text exposition format. Histograms hold the timed calls only.
+// The fine HDR buckets are summarised
+// into power-of-four boundaries from 1us to about 4.5 minutes.
+void Metrics::writePrometheus(ostream& out) const {
+    out << "# HELP skynet_operation_latency_seconds Latency of ATC operations.\n"
+        << "# TYPE skynet_operation_latency_seconds histogram\n";
+    for (int i = 0; i < OP_COUNT; i++) {
+        const LatencyHistogram& h = latencies[i];
+        unsigned long long bound = 1000;
+        for (int b = 0; b < 15; b++, bound *= 4) {
+            out << "skynet_operation_latency_seconds_bucket{op=\"" << OPERATION_NAMES[i]
+                << "\",le=\"" << bound / 1e9 << "\"} " << h.countAtOrBelow(bound) << "\n";
+        }
+        out << "skynet_operation_latency_seconds_bucket{op=\"" << OPERATION_NAMES[i]
+            << "\",le=\"+Inf\"} " << h.getCount() << "\n"
+            << "skynet_operation_latency_seconds_sum{op=\"" << OPERATION_NAMES[i] << "\"} "
+            << h.getSum() / 1e9 << "\n"
+            << "skynet_operation_latency_seconds_count{op=\"" << OPERATION_NAMES[i] << "\"} "
+            << h.getCount() << "\n";
+    }
+
+    out << "# HELP skynet_operation_calls_total Calls per operation, timed or not.\n"
+        << "# TYPE skynet_operation_calls_total counter\n";
+    for (int i = 0; i < OP_COUNT; i++) {
+        out << "skynet_operation_calls_total{op=\"" << OPERATION_NAMES[i] << "\"} " << calls[i] << "\n";
+    }
+
+    out << "# HELP skynet_events_total Counted ATC events.\n"
+        << "# TYPE skynet_events_total counter\n";
+    for (int i = 0; i < CTR_COUNT; i++) {
+        out << "skynet_events_total{event=\"" << COUNTER_NAMES[i] << "\"} " << counters[i] << "\n";
+    }
+    out.flush();
+}
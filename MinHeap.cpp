@@ -1,6 +1,7 @@
 #include "MinHeap.h"
 #include "Exceptions.h"
 #include "Colors.h"
+#include "Metrics.h"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
@@ -11,15 +12,28 @@ int MinHeap::parent(int i) { return (i - 1) / 2; }
 int MinHeap::leftChild(int i) { return 2 * i + 1; }
 int MinHeap::rightChild(int i) { return 2 * i + 2; }
 
-void MinHeap::swap(Aircraft& a, Aircraft& b) {
-    Aircraft temp = a;
-    a = b;
-    b = temp;
+// Priority dominates, then lower fuel, then earlier timestamp. Reads only
+// the store's hot columns.
+unsigned long long MinHeap::keyOf(int handle) const {
+    const AircraftStore& store = registry.getStore();
+    unsigned long long priority = (unsigned long long)(store.priority(handle) & 0xFF);
+    int fuel = store.fuelLevel(handle);
+    if (fuel < 0) fuel = 0;
+    if (fuel > 255) fuel = 255;
+    return (priority << 40) | ((unsigned long long)fuel << 32) | (unsigned int)store.timestamp(handle);
+}
+
+void MinHeap::swap(int i, int j) {
+    HeapEntry temp = heap[i];
+    heap[i] = heap[j];
+    heap[j] = temp;
+    position[heap[i].handle] = i;
+    position[heap[j].handle] = j;
 }
 
 void MinHeap::heapifyUp(int i) {
-    while (i > 0 && heap[parent(i)].priority > heap[i].priority) {
-        swap(heap[parent(i)], heap[i]);
+    while (i > 0 && heap[parent(i)].key > heap[i].key) {
+        swap(parent(i), i);
         i = parent(i);
     }
 }
@@ -29,57 +43,90 @@ void MinHeap::heapifyDown(int i) {
     int left = leftChild(i);
     int right = rightChild(i);
 
-    if (left < size && heap[left].priority < heap[smallest].priority)
+    if (left < size && heap[left].key < heap[smallest].key)
         smallest = left;
-    if (right < size && heap[right].priority < heap[smallest].priority)
+    if (right < size && heap[right].key < heap[smallest].key)
         smallest = right;
 
     if (smallest != i) {
-        swap(heap[i], heap[smallest]);
+        swap(i, smallest);
         heapifyDown(smallest);
     }
 }
 
-MinHeap::MinHeap() : size(0) {}
+void MinHeap::ensurePosition(int handle) {
+    if (handle >= position.getSize()) {
+        position.resize(handle + 1, -1);
+    }
+}
 
-bool MinHeap::isEmpty() const { return size == 0; }
-int MinHeap::getSize() const { return size; }
+int MinHeap::locate(int handle) const {
+    if (handle < 0 || handle >= position.getSize()) {
+        return -1;
+    }
+    return position[handle];
+}
 
-void MinHeap::insert(const Aircraft& aircraft) {
-    if (size >= MAX_FLIGHTS) {
-        throw HeapFullException();
+void MinHeap::removeAt(int i) {
+    position[heap[i].handle] = -1;
+    size--;
+    if (i < size) {
+        heap[i] = heap[size];
+        position[heap[i].handle] = i;
+        heapifyDown(i);
+        heapifyUp(i);
     }
+    heap.popBack();
+}
+
+MinHeap::MinHeap(HashTable& registry) : registry(registry), size(0) {}
+
+bool MinHeap::isEmpty() const { return size == 0; }
+int MinHeap::getSize() const { return size; }
+bool MinHeap::contains(int handle) const { return locate(handle) != -1; }
 
-    if (strlen(aircraft.flightID) == 0) {
+void MinHeap::insert(int handle) {
+    const AircraftStore& store = registry.getStore();
+    if (handle < 0 || handle >= store.getHandleLimit() || strlen(store.flightID(handle)) == 0) {
         throw InvalidFlightDataException("Cannot insert aircraft with empty flight ID");
     }
+    if (locate(handle) != -1) {
+        throw DuplicateFlightException(store.flightID(handle));
+    }
 
-    heap[size] = aircraft;
-    heapifyUp(size);
+    ensurePosition(handle);
+    HeapEntry entry;
+    entry.key = keyOf(handle);
+    entry.handle = handle;
+    heap.pushBack(entry);
+    position[handle] = size;
     size++;
+    heapifyUp(size - 1);
 }
 
-Aircraft MinHeap::extractMin() {
+// Removes the most urgent flight and returns its registry handle, leaving the
+// record itself where it is.
+int MinHeap::extractMinHandle() {
     if (isEmpty()) {
+        METRIC_COUNT(CTR_HEAP_EMPTY);
         throw HeapEmptyException();
     }
 
-    Aircraft min = heap[0];
-    heap[0] = heap[size - 1];
-    size--;
-
-    if (size > 0) {
-        heapifyDown(0);
-    }
+    int handle = heap[0].handle;
+    removeAt(0);
+    return handle;
+}
 
-    return min;
+Aircraft MinHeap::extractMin() {
+    return registry.get(extractMinHandle());
 }
 
 Aircraft MinHeap::peekMin() const {
     if (isEmpty()) {
+        METRIC_COUNT(CTR_HEAP_EMPTY);
         throw HeapEmptyException();
     }
-    return heap[0];
+    return registry.get(heap[0].handle);
 }
 
 bool MinHeap::decreaseKey(const char* flightID, int newPriority) {
@@ -91,19 +138,51 @@ bool MinHeap::decreaseKey(const char* flightID, int newPriority) {
         throw OutOfRangeException("Priority (must be 1-4)");
     }
 
-    for (int i = 0; i < size; i++) {
-        if (strcmp(heap[i].flightID, flightID) == 0) {
-            if (newPriority < heap[i].priority) {
-                heap[i].priority = newPriority;
-                heapifyUp(i);
-                return true;
-            }
-            return false;
-        }
+    int handle = registry.findHandle(flightID);
+    int i = locate(handle);
+    if (i == -1) {
+        return false;
+    }
+
+    if (newPriority < (int)(heap[i].key >> 40)) {
+        registry.getStore().priority(handle) = newPriority;
+        heap[i].key = keyOf(handle);
+        heapifyUp(i);
+        return true;
     }
     return false;
 }
 
+// Re-reads the registry record after an in-place change (fuel burn, priority)
+// and moves the entry to its new place in the queue.
+bool MinHeap::refresh(const char* flightID) {
+    return refreshHandle(registry.findHandle(flightID));
+}
+
+bool MinHeap::refreshHandle(int handle) {
+    int i = locate(handle);
+    if (i == -1) {
+        return false;
+    }
+
+    heap[i].key = keyOf(handle);
+    heapifyUp(i);
+    heapifyDown(position[handle]);
+    return true;
+}
+
+// Recomputes every key and rebuilds the heap bottom-up in O(n). Cheaper than
+// n refreshes when most records changed at once, e.g. after a simulation
+// tick burned fuel on every queued aircraft.
+void MinHeap::rekeyAll() {
+    for (int i = 0; i < size; i++) {
+        heap[i].key = keyOf(heap[i].handle);
+    }
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        heapifyDown(i);
+    }
+}
+
 void MinHeap::displayQueue() const {
     if (isEmpty()) {
         setColor(14); 
@@ -118,22 +197,22 @@ void MinHeap::displayQueue() const {
     cout << "  +------+------------+----------+------+-----------+" << endl;
     setColor(15);
 
-    Aircraft temp[MAX_FLIGHTS];
-    for (int i = 0; i < size; i++) temp[i] = heap[i];
+    DynamicArray<HeapEntry> temp(heap);
 
     for (int i = 0; i < size && i < 10; i++) {
         int minIdx = i;
         for (int j = i + 1; j < size; j++) {
-            if (temp[j].priority < temp[minIdx].priority)
+            if (temp[j].key < temp[minIdx].key)
                 minIdx = j;
         }
-        Aircraft t = temp[i];
+        HeapEntry t = temp[i];
         temp[i] = temp[minIdx];
         temp[minIdx] = t;
 
+        Aircraft flight = registry.get(temp[i].handle);
         const char* status;
         int statusColor;
-        switch (temp[i].priority) {
+        switch (flight.priority) {
         case 1: status = "CRITICAL"; statusColor = 12; break;  
         case 2: status = "HIGH"; statusColor = 14; break;    
         case 3: status = "MEDIUM"; statusColor = 10; break;   
@@ -147,19 +226,19 @@ void MinHeap::displayQueue() const {
         setColor(3);
         cout << " | ";
         setColor(11);
-        cout << left << setw(10) << temp[i].flightID;
+        cout << left << setw(10) << flight.flightID;
         setColor(3);
         cout << " | ";
         setColor(statusColor);
-        cout << setw(8) << temp[i].priority;
+        cout << setw(8) << flight.priority;
         setColor(3);
         cout << " | ";
 
         // Fuel color based on level
-        if (temp[i].fuelLevel < 20) setColor(12);     
-        else if (temp[i].fuelLevel < 50) setColor(14); 
+        if (flight.fuelLevel < 20) setColor(12);     
+        else if (flight.fuelLevel < 50) setColor(14); 
         else setColor(10);                             
-        cout << setw(3) << temp[i].fuelLevel << "%";
+        cout << setw(3) << flight.fuelLevel << "%";
 
         setColor(3);
         cout << " | ";
@@ -179,14 +258,54 @@ bool MinHeap::removeByFlightID(const char* flightID) {
         return false;
     }
 
+    return removeHandle(registry.findHandle(flightID));
+}
+
+bool MinHeap::removeHandle(int handle) {
+    int i = locate(handle);
+    if (i == -1) {
+        return false;
+    }
+    removeAt(i);
+    return true;
+}
+
+// Original O(n) lookups that strcmp every queued flight ID, kept as the
+// reference the indexed decreaseKey and removal are benchmarked against.
+bool MinHeap::decreaseKeyLinearScan(const char* flightID, int newPriority) {
+    if (flightID == nullptr || strlen(flightID) == 0) {
+        throw InvalidInputException("Invalid flight ID for decreaseKey");
+    }
+
+    if (newPriority < 1 || newPriority > 4) {
+        throw OutOfRangeException("Priority (must be 1-4)");
+    }
+
+    const AircraftStore& store = registry.getStore();
+    for (int i = 0; i < size; i++) {
+        int handle = heap[i].handle;
+        if (strcmp(store.getDetails(handle).flightID, flightID) != 0) continue;
+
+        if (newPriority < (int)(heap[i].key >> 40)) {
+            registry.getStore().priority(handle) = newPriority;
+            heap[i].key = keyOf(handle);
+            heapifyUp(i);
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+bool MinHeap::removeLinearScan(const char* flightID) {
+    if (flightID == nullptr || strlen(flightID) == 0) {
+        return false;
+    }
+
+    const AircraftStore& store = registry.getStore();
     for (int i = 0; i < size; i++) {
-        if (strcmp(heap[i].flightID, flightID) == 0) {
-            heap[i] = heap[size - 1];
-            size--;
-            if (size > 0 && i < size) {
-                heapifyDown(i);
-                heapifyUp(i);
-            }
+        if (strcmp(store.getDetails(heap[i].handle).flightID, flightID) == 0) {
+            removeAt(i);
             return true;
         }
     }
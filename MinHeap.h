@@ -3,29 +3,52 @@
 
 #include "Constants.h"
 #include "Aircraft.h"
+#include "HashTable.h"
+#include "DynamicArray.h"
+
+// Landing queue entry: a packed sort key (priority, fuel, timestamp) and the
+// handle of the aircraft record in the registry.
+struct HeapEntry {
+    unsigned long long key;
+    int handle;
+};
 
 class MinHeap {
 private:
-    Aircraft heap[MAX_FLIGHTS];
+    HashTable& registry;
+    DynamicArray<HeapEntry> heap;
+    DynamicArray<int> position;  // registry handle -> heap slot, -1 when not queued
     int size;
 
     int parent(int i);
     int leftChild(int i);
     int rightChild(int i);
-    void swap(Aircraft& a, Aircraft& b);
+    void swap(int i, int j);
     void heapifyUp(int i);
     void heapifyDown(int i);
+    int locate(int handle) const;
+    void removeAt(int i);
+    void ensurePosition(int handle);
+    unsigned long long keyOf(int handle) const;
 
 public:
-    MinHeap();
+    MinHeap(HashTable& registry);
     bool isEmpty() const;
     int getSize() const;
-    void insert(const Aircraft& aircraft);
+    bool contains(int handle) const;
+    void insert(int handle);
+    int extractMinHandle();
     Aircraft extractMin();
     Aircraft peekMin() const;
     bool decreaseKey(const char* flightID, int newPriority);
+    bool refresh(const char* flightID);
+    bool refreshHandle(int handle);
+    void rekeyAll();
     void displayQueue() const;
     bool removeByFlightID(const char* flightID);
+    bool removeHandle(int handle);
+    bool decreaseKeyLinearScan(const char* flightID, int newPriority);
+    bool removeLinearScan(const char* flightID);
 };
 
 #endif
@@ -0,0 +1,96 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// The sources use the MSVC bounds-checked C string and time functions.
+// Outside Windows toolchains these map them onto their POSIX equivalents.
+#ifndef _WIN32
+
+#include <cstring>
+#include <cstddef>
+#include <ctime>
+
+inline int strcpy_s(char* dest, size_t size, const char* src) {
+    if (dest == nullptr || size == 0) return 1;
+    size_t len = strlen(src);
+    if (len >= size) {
+        dest[0] = '\0';
+        return 1;
+    }
+    memcpy(dest, src, len + 1);
+    return 0;
+}
+
+inline int strcat_s(char* dest, size_t size, const char* src) {
+    if (dest == nullptr || size == 0) return 1;
+    size_t used = strlen(dest);
+    size_t len = strlen(src);
+    if (used + len >= size) return 1;
+    memcpy(dest + used, src, len + 1);
+    return 0;
+}
+
+inline char* strtok_s(char* str, const char* delim, char** context) {
+    return strtok_r(str, delim, context);
+}
+
+inline int localtime_s(struct tm* result, const time_t* t) {
+    return localtime_r(t, result) != nullptr ? 0 : 1;
+}
+
+#endif
+
+// Moves from over to in one step, replacing any existing file, so a reader
+// sees either the old or the new file and never neither (the snapshot's
+// temp-file rename). POSIX rename already does this; Windows rename refuses
+// to overwrite, so MoveFileEx is used there.
+#ifdef _WIN32
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+inline bool replaceFile(const char* from, const char* to) {
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+// Forces a closed file's contents to disk, so a later replaceFile cannot
+// become durable before the data it points at.
+inline bool syncFile(const char* path) {
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    bool ok = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return ok;
+}
+
+#else
+
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+inline bool syncFile(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+// The rename itself is made durable by syncing the directory that holds
+// it, where the file system allows that.
+inline bool replaceFile(const char* from, const char* to) {
+    if (rename(from, to) != 0) return false;
+    std::string directory(to);
+    size_t slash = directory.find_last_of('/');
+    directory = slash == std::string::npos ? "." : directory.substr(0, slash + 1);
+    syncFile(directory.c_str());
+    return true;
+}
+
+#endif
+
+#endif
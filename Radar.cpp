@@ -3,30 +3,33 @@
 #include "Colors.h"
 #include <iostream>
 #include <iomanip>
+#include <cstdio>
 
 using namespace std;
 
-Radar::Radar() {
+Radar::Radar() : width(GRID_SIZE), height(GRID_SIZE) {
     clear();
 }
 
+char& Radar::cell(int x, int y) { return grid[y * width + x]; }
+char Radar::cell(int x, int y) const { return grid[y * width + x]; }
+
 void Radar::clear() {
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            grid[i][j] = '.';
-        }
-    }
+    grid.clear();
+    grid.resize(width * height, '.');
 }
 
 void Radar::initialize(Graph& graph) {
+    width = graph.getWidth();
+    height = graph.getHeight();
     clear();
 
     try {
         for (int i = 0; i < graph.getNodeCount(); i++) {
             int x = graph.getNodeX(i);
             int y = graph.getNodeY(i);
-            if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE) {
-                grid[y][x] = graph.getIsAirport(i) ? 'A' : 'W';
+            if (x >= 0 && x < width && y >= 0 && y < height) {
+                cell(x, y) = graph.getIsAirport(i) ? 'A' : 'W';
             }
         }
     }
@@ -35,95 +38,103 @@ void Radar::initialize(Graph& graph) {
     }
 }
 
-void Radar::placePlanes(Aircraft* flights, int count) {
-    if (flights == nullptr && count > 0) {
-        throw InvalidInputException("Null flights array");
-    }
-
-    for (int i = 0; i < count; i++) {
+void Radar::placePlanes(const DynamicArray<Aircraft>& flights) {
+    for (int i = 0; i < flights.getSize(); i++) {
         int x = flights[i].gridX;
         int y = flights[i].gridY;
-        if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE) {
-            grid[y][x] = 'P';
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            cell(x, y) = 'P';
         }
     }
 }
 
 bool Radar::isOccupied(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
         return true;
     }
-    return grid[y][x] == 'P';
+    return cell(x, y) == 'P';
 }
 
-void Radar::display() const {
+// Appends text in the given color. An escape is emitted only when the color
+// actually changes, so a run of same-colored text costs a single sequence.
+static void appendColored(string& frame, int& current, int color, const char* text) {
+    if (color != current) {
+        frame += ansiColor(color);
+        current = color;
+    }
+    frame += text;
+}
+
+// Builds the whole radar frame in memory, ready for one write.
+void Radar::renderFrame(string& frame) const {
+    frame.clear();
+    frame.reserve((size_t)(width * 2 + 16) * (height + 8));
+    int current = -1;
+    char text[16];
+
     // Column headers
-    setColor(14); 
-    cout << "\n     ";
-    for (int i = 0; i < GRID_SIZE; i++) cout << setw(2) << i;
-    cout << endl;
+    appendColored(frame, current, 14, "\n     ");
+    for (int i = 0; i < width; i++) {
+        snprintf(text, sizeof(text), "%2d", i);
+        appendColored(frame, current, 14, text);
+    }
+    frame += "\n";
 
     // Top border
-    setColor(3);
-    cout << "    +";
-    for (int i = 0; i < GRID_SIZE * 2 + 1; i++) cout << "-";
-    cout << "+" << endl;
+    appendColored(frame, current, 3, "    +");
+    frame.append(width * 2 + 1, '-');
+    frame += "+\n";
 
     // Grid rows
-    for (int i = 0; i < GRID_SIZE; i++) {
-        setColor(14);
-        cout << setw(2) << i << "  ";
-        setColor(3); 
-        cout << "|";
-
-        for (int j = 0; j < GRID_SIZE; j++) {
-            char c = grid[i][j];
-            cout << " ";
-
+    for (int i = 0; i < height; i++) {
+        snprintf(text, sizeof(text), "%2d  ", i);
+        appendColored(frame, current, 14, text);
+        appendColored(frame, current, 3, "|");
+
+        for (int j = 0; j < width; j++) {
+            char c = cell(j, i);
+            int color;
             switch (c) {
-            case 'P':
-                setColor(14); // Yellow - Plane
-                break;
-            case 'A':
-                setColor(10); // Green - Airport
-                break;
-            case 'W':
-                setColor(11); // Cyan - Waypoint
-                break;
-            default:
-                setColor(8); // Dark Gray - Empty
-                break;
+            case 'P': color = 14; break;    // Yellow - Plane
+            case 'A': color = 10; break;    // Green - Airport
+            case 'W': color = 11; break;    // Cyan - Waypoint
+            default: color = 8; break;      // Dark Gray - Empty
             }
-            cout << c;
-            setColor(3); // Reset for grid
+            // The separating space is blank in any color, so it never
+            // breaks a run.
+            frame += ' ';
+            if (color != current) {
+                frame += ansiColor(color);
+                current = color;
+            }
+            frame += c;
         }
 
-        setColor(3); 
-        cout << " |" << endl;
+        appendColored(frame, current, 3, " |\n");
     }
 
     // Bottom border
-    cout << "    +";
-    for (int i = 0; i < GRID_SIZE * 2 + 1; i++) cout << "-";
-    cout << "+" << endl;
-
-    cout << "\n  ";
-    setColor(15); 
-    cout << "Legend: ";
-    setColor(14); 
-    cout << "P";
-    setColor(15);
-    cout << "=Plane  ";
-    setColor(10);
-    cout << "A";
-    setColor(15);
-    cout << "=Airport  ";
-    setColor(11); 
-    cout << "W";
-    setColor(15);
-    cout << "=Waypoint  ";
-    setColor(8); 
-    cout << ".";
+    appendColored(frame, current, 3, "    +");
+    frame.append(width * 2 + 1, '-');
+    frame += "+\n";
+
+    frame += "\n  ";
+    appendColored(frame, current, 15, "Legend: ");
+    appendColored(frame, current, 14, "P");
+    appendColored(frame, current, 15, "=Plane  ");
+    appendColored(frame, current, 10, "A");
+    appendColored(frame, current, 15, "=Airport  ");
+    appendColored(frame, current, 11, "W");
+    appendColored(frame, current, 15, "=Waypoint  ");
+    appendColored(frame, current, 8, ".");
+    appendColored(frame, current, 15, "=Empty\n");
+}
+
+void Radar::display() const {
+    string frame;
+    renderFrame(frame);
+    cout.flush();
+    cout.write(frame.data(), (streamsize)frame.size());
+    cout.flush();
     setColor(15);
-    cout << "=Empty" << endl;
 }
@@ -4,16 +4,23 @@
 #include "Constants.h"
 #include "Aircraft.h"
 #include "Graph.h"
+#include "DynamicArray.h"
+#include <string>
 
 class Radar {
 private:
-    char grid[GRID_SIZE][GRID_SIZE];
+    DynamicArray<char> grid;    // row-major, width * height cells
+    int width, height;
+
+    char& cell(int x, int y);
+    char cell(int x, int y) const;
 
 public:
     Radar();
     void initialize(Graph& graph);
-    void placePlanes(Aircraft* flights, int count);
+    void placePlanes(const DynamicArray<Aircraft>& flights);
     bool isOccupied(int x, int y) const;
+    void renderFrame(std::string& frame) const;
     void display() const;
     void clear();
 };
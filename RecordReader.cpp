@@ -0,0 +1,144 @@
+#include "RecordReader.h"
+#include "Exceptions.h"
+#include <charconv>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+RecordReader::RecordReader()
+    : filename(""), cursor(nullptr), limit(nullptr), lineNumber(0), fieldCount(0), terminated(false) {
+}
+
+// False when the file is missing or empty, which callers treat as no data.
+bool RecordReader::open(const char* name) {
+    filename = name;
+    lineNumber = 0;
+    fieldCount = 0;
+    if (!mapped.open(name)) {
+        cursor = limit = nullptr;
+        return false;
+    }
+    cursor = (const char*)mapped.data();
+    limit = cursor + mapped.size();
+    return true;
+}
+
+// Moves to the next non-blank line and splits it on '|'.
+bool RecordReader::next() {
+    while (cursor != nullptr && cursor < limit) {
+        const char* lineEnd = (const char*)memchr(cursor, '\n', (size_t)(limit - cursor));
+        const char* nextLine = lineEnd == nullptr ? limit : lineEnd + 1;
+        terminated = lineEnd != nullptr;
+        if (lineEnd == nullptr) lineEnd = limit;
+        if (lineEnd > cursor && lineEnd[-1] == '\r') lineEnd--;
+
+        const char* start = cursor;
+        cursor = nextLine;
+        lineNumber++;
+        if (lineEnd == start) continue;
+
+        fieldCount = 0;
+        const char* p = start;
+        while (true) {
+            const char* bar = (const char*)memchr(p, '|', (size_t)(lineEnd - p));
+            if (fieldCount == RECORD_MAX_FIELDS) {
+                fail("too many fields");
+            }
+            fields[fieldCount].begin = p;
+            fields[fieldCount].end = bar == nullptr ? lineEnd : bar;
+            fieldCount++;
+            if (bar == nullptr) break;
+            p = bar + 1;
+        }
+        return true;
+    }
+    return false;
+}
+
+long long RecordReader::getLineNumber() const { return lineNumber; }
+
+int RecordReader::getFieldCount() const { return fieldCount; }
+
+// True when the current line starts with '#'.
+bool RecordReader::isComment() const {
+    return fieldCount > 0 && fields[0].begin < fields[0].end && *fields[0].begin == '#';
+}
+
+// False for a last line with no newline, e.g. the tail of an interrupted
+// append.
+bool RecordReader::isTerminated() const {
+    return terminated;
+}
+
+size_t RecordReader::getSize() const { return mapped.size(); }
+
+// Lines in the whole file, blank ones included: an upper bound on the
+// record count, for sizing containers before a bulk load.
+long long RecordReader::countLines() const {
+    const char* p = (const char*)mapped.data();
+    const char* end = p + mapped.size();
+    long long lines = 0;
+    while (p < end) {
+        const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+        lines++;
+        if (newline == nullptr) break;
+        p = newline + 1;
+    }
+    return lines;
+}
+
+void RecordReader::fail(const char* reason) const {
+    throw ParseException(filename, lineNumber, reason);
+}
+
+void RecordReader::expectFields(int count) const {
+    if (fieldCount != count) {
+        string reason = "expected " + to_string(count) + " fields, found " + to_string(fieldCount);
+        fail(reason.c_str());
+    }
+}
+
+const TextField& RecordReader::field(int index, const char* name) const {
+    if (index < 0 || index >= fieldCount) {
+        string reason = string("missing field ") + name;
+        fail(reason.c_str());
+    }
+    return fields[index];
+}
+
+int RecordReader::readInt(int index, const char* name) const {
+    const TextField& f = field(index, name);
+    int value = 0;
+    from_chars_result result = from_chars(f.begin, f.end, value);
+    if (result.ec != errc() || result.ptr != f.end) {
+        string reason = string(name) + " is not an integer";
+        fail(reason.c_str());
+    }
+    return value;
+}
+
+bool RecordReader::readFlag(int index, const char* name) const {
+    const TextField& f = field(index, name);
+    if (f.end - f.begin != 1 || (*f.begin != '0' && *f.begin != '1')) {
+        string reason = string(name) + " must be 0 or 1";
+        fail(reason.c_str());
+    }
+    return *f.begin == '1';
+}
+
+// Copies the field into dest as a C string. capacity includes the NUL.
+void RecordReader::readText(int index, char* dest, int capacity, const char* name, bool required) const {
+    const TextField& f = field(index, name);
+    size_t length = (size_t)(f.end - f.begin);
+    if (required && length == 0) {
+        string reason = string(name) + " is empty";
+        fail(reason.c_str());
+    }
+    if (length >= (size_t)capacity) {
+        string reason = string(name) + " is longer than " + to_string(capacity - 1) + " characters";
+        fail(reason.c_str());
+    }
+    memcpy(dest, f.begin, length);
+    dest[length] = '\0';
+}
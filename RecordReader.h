@@ -0,0 +1,55 @@
+#ifndef RECORDREADER_H
+#define RECORDREADER_H
+
+#include "MappedFile.h"
+
+const int RECORD_MAX_FIELDS = 16;
+
+// One field of the current line. Points into the mapped file, so it is only
+// valid until the reader moves on; it is not NUL-terminated.
+struct TextField {
+    const char* begin;
+    const char* end;
+};
+
+// Streams the lines of a pipe-delimited file (flights.txt, flightlog.txt)
+// straight out of a memory mapping. Fields are located in place with memchr
+// and numbers are converted with std::from_chars, so nothing is copied
+// until a field is stored. Blank lines are skipped and a trailing '\r' is
+// ignored. Anything malformed throws ParseException with the file name and
+// the 1-based line number.
+class RecordReader {
+private:
+    MappedFile mapped;
+    const char* filename;
+    const char* cursor;
+    const char* limit;
+    long long lineNumber;
+    TextField fields[RECORD_MAX_FIELDS];
+    int fieldCount;
+    bool terminated;
+
+    const TextField& field(int index, const char* name) const;
+
+public:
+    RecordReader();
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+
+    bool open(const char* filename);
+    bool next();
+    long long getLineNumber() const;
+    int getFieldCount() const;
+    bool isComment() const;
+    bool isTerminated() const;
+    size_t getSize() const;
+    long long countLines() const;
+
+    void expectFields(int count) const;
+    void fail(const char* reason) const;
+    int readInt(int index, const char* name) const;
+    bool readFlag(int index, const char* name) const;
+    void readText(int index, char* dest, int capacity, const char* name, bool required) const;
+};
+
+#endif
@@ -0,0 +1,315 @@
+#include "ScriptRunner.h"
+#include "Exceptions.h"
+#include "Metrics.h"
+#include <chrono>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <string>
+
+using namespace std;
+
+static const char* SCRIPT_DELIMS = " \t\r\n";
+
+static const char* nextToken(char*& context, const char* name) {
+    char* token = strtok_s(nullptr, SCRIPT_DELIMS, &context);
+    if (token == nullptr) {
+        char message[64];
+        strcpy_s(message, sizeof(message), "Missing argument: ");
+        strcat_s(message, sizeof(message), name);
+        throw InvalidInputException(message);
+    }
+    return token;
+}
+
+static int nextInt(char*& context, const char* name, long long low = -INF, long long high = INF) {
+    const char* token = nextToken(context, name);
+    char* end = nullptr;
+    errno = 0;
+    long long value = strtoll(token, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value < low || value > high) {
+        throw OutOfRangeException(name);
+    }
+    return (int)value;
+}
+
+// Unix timestamps run past INF, so they get the full int range.
+static int nextTimestamp(char*& context, const char* name) {
+    return nextInt(context, name, INT_MIN, INT_MAX);
+}
+
+static bool commandIs(const char* command, const char* name) {
+    for (; *command && *name; command++, name++) {
+        char c = *command;
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        if (c != *name) return false;
+    }
+    return *command == '\0' && *name == '\0';
+}
+
+ScriptRunner::ScriptRunner(ATCSystem& system, bool quietMode)
+    : atc(system), quiet(quietMode), executed(0), failed(0), elapsedSeconds(0.0) {}
+
+long long ScriptRunner::getExecutedCount() const {
+    return executed;
+}
+
+long long ScriptRunner::getFailedCount() const {
+    return failed;
+}
+
+void ScriptRunner::run(istream& input) {
+    string line;
+    int lineNumber = 0;
+    auto start = chrono::steady_clock::now();
+
+    while (getline(input, line)) {
+        lineNumber++;
+
+        size_t first = line.find_first_not_of(SCRIPT_DELIMS);
+        if (first == string::npos || line[first] == '#') {
+            continue;
+        }
+
+        executed++;
+        try {
+            execute(&line[0]);
+        }
+        catch (const ATCException& e) {
+            failed++;
+            cerr << "line " << lineNumber << ": " << e.what() << endl;
+        }
+    }
+
+    elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void ScriptRunner::printSummary(ostream& out) const {
+    double rate = elapsedSeconds > 0.0 ? executed / elapsedSeconds : 0.0;
+    out << "Executed " << executed << " commands (" << failed << " failed) in "
+        << elapsedSeconds << " s, " << (long long)rate << " commands/sec" << endl;
+}
+
+void ScriptRunner::execute(char* line) {
+    char* context = nullptr;
+    char* command = strtok_s(line, SCRIPT_DELIMS, &context);
+
+    if (commandIs(command, "ADD")) runAdd(context);
+    else if (commandIs(command, "MOVE")) runMove(context);
+    else if (commandIs(command, "EMERGENCY")) runEmergency(context);
+    else if (commandIs(command, "LAND")) runLand();
+    else if (commandIs(command, "SEARCH")) runSearch(context);
+    else if (commandIs(command, "ROUTE")) runRoute(context);
+    else if (commandIs(command, "LOG")) runLog(context);
+    else if (commandIs(command, "TICK")) runTick(context);
+    else if (commandIs(command, "METRICS")) runMetrics(context);
+    else if (commandIs(command, "SAVE")) {
+        atc.writeState();
+        if (!quiet) cout << "SAVED" << endl;
+    }
+    else if (commandIs(command, "LOAD")) {
+        atc.readState();
+        if (!quiet) cout << "LOADED" << endl;
+    }
+    else if (commandIs(command, "EXPORT")) runTextFiles(context, true);
+    else if (commandIs(command, "IMPORT")) runTextFiles(context, false);
+    else {
+        throw InvalidInputException("Unknown command");
+    }
+}
+
+void ScriptRunner::runAdd(char* context) {
+    Aircraft flight;
+    flight.setFlightID(nextToken(context, "flight ID"));
+    flight.setModel(nextToken(context, "model"));
+    flight.fuelLevel = nextInt(context, "fuel");
+    flight.setOrigin(nextToken(context, "origin"));
+    flight.setDestination(nextToken(context, "destination"));
+    flight.priority = nextInt(context, "priority");
+    int nodeID = nextInt(context, "node");
+
+    atc.spawnFlight(flight, nodeID);
+    if (!quiet) cout << "ADDED " << flight.flightID << endl;
+}
+
+void ScriptRunner::runMove(char* context) {
+    const char* flightID = nextToken(context, "flight ID");
+    int nodeID = nextInt(context, "node");
+
+    bool upgraded = atc.relocateFlight(flightID, nodeID);
+    if (!quiet) {
+        cout << "MOVED " << flightID << " " << atc.getGraph().getNodeName(nodeID);
+        if (upgraded) cout << " (low fuel, priority HIGH)";
+        cout << endl;
+    }
+}
+
+void ScriptRunner::runEmergency(char* context) {
+    const char* flightID = nextToken(context, "flight ID");
+    int type = nextInt(context, "emergency type");
+
+    bool changed = atc.applyEmergency(flightID, type);
+    if (!quiet) {
+        cout << "EMERGENCY " << flightID << (changed ? "" : " (priority unchanged)") << endl;
+    }
+}
+
+void ScriptRunner::runLand() {
+    Aircraft landed = atc.landNextFlight();
+    if (!quiet) cout << "LANDED " << landed.flightID << endl;
+}
+
+void ScriptRunner::runSearch(char* context) {
+    const char* flightID = nextToken(context, "flight ID");
+
+    Aircraft flight;
+    if (!atc.findFlight(flightID, flight)) {
+        throw FlightNotFoundException(flightID);
+    }
+    if (!quiet) {
+        cout << "FOUND " << flight.flightID << " " << flight.model
+            << " fuel=" << flight.fuelLevel << " priority=" << flight.priority
+            << " pos=(" << flight.gridX << "," << flight.gridY << ") "
+            << (flight.inAir ? "IN_AIR" : "LANDED") << endl;
+    }
+}
+
+void ScriptRunner::runRoute(char* context) {
+    const char* flightID = nextToken(context, "flight ID");
+
+    DynamicArray<int> path;
+    atc.routeToSafety(flightID, path);
+    if (!quiet) {
+        const Graph& graph = atc.getGraph();
+        cout << "ROUTE " << flightID;
+        for (int i = 0; i < path.getSize(); i++) {
+            cout << (i == 0 ? " " : " -> ") << graph.getNodeName(path[i]);
+        }
+        cout << endl;
+    }
+}
+
+// Prints one ENTRY line per log entry (rank, timestamp, flight, origin,
+// destination, status) and a LOG summary line. For FLIGHT the rank is the
+// position in that flight's history and the total its entry count.
+void ScriptRunner::runLog(char* context) {
+    const char* mode = nextToken(context, "log query");
+    const FlightLog& log = atc.getFlightLog();
+
+    if (commandIs(mode, "FLIGHT")) {
+        const char* flightID = nextToken(context, "flight ID");
+        int shown = 0;
+        for (HistoryCursor entry = log.history(flightID); entry.isValid(); entry.next(), shown++) {
+            if (quiet) continue;
+            cout << "ENTRY " << shown << " " << entry.timestamp() << " " << entry.flightID()
+                << " " << entry.origin() << " " << entry.destination() << " " << entry.status() << endl;
+        }
+        if (!quiet) cout << "LOG " << shown << " of " << shown << endl;
+        return;
+    }
+
+    int total = log.getCount();
+    LogCursor cursor;
+    int rank = 0;
+    if (commandIs(mode, "RANGE")) {
+        int from = nextTimestamp(context, "from timestamp");
+        int to = nextTimestamp(context, "to timestamp");
+        cursor = log.range(from, to);
+        rank = log.countBefore(from);
+    }
+    else if (commandIs(mode, "LAST")) {
+        int count = nextInt(context, "entry count");
+        if (count < 0) {
+            throw OutOfRangeException("entry count");
+        }
+        rank = count < total ? total - count : 0;
+        cursor = log.fromRank(rank, count);
+    }
+    else if (commandIs(mode, "PAGE")) {
+        int page = nextInt(context, "page");
+        int pageSize = nextInt(context, "page size");
+        if (page < 0 || pageSize < 1) {
+            throw OutOfRangeException("page");
+        }
+        long long first = (long long)page * pageSize;
+        rank = first < total ? (int)first : total;
+        cursor = log.fromRank(rank, pageSize);
+    }
+    else {
+        throw InvalidInputException("Unknown log query (RANGE, LAST, PAGE or FLIGHT)");
+    }
+
+    int shown = 0;
+    for (; cursor.isValid(); cursor.next(), shown++) {
+        if (quiet) continue;
+        cout << "ENTRY " << rank + shown << " " << cursor.timestamp() << " " << cursor.flightID()
+            << " " << cursor.origin() << " " << cursor.destination() << " " << cursor.status() << endl;
+    }
+    if (!quiet) cout << "LOG " << shown << " of " << total << endl;
+}
+
+void ScriptRunner::runTick(char* context) {
+    int count = 1;
+    if (context != nullptr && context[strspn(context, SCRIPT_DELIMS)] != '\0') {
+        count = nextInt(context, "tick count");
+        if (count < 1) {
+            throw OutOfRangeException("tick count");
+        }
+    }
+
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    for (int i = 0; i < count; i++) {
+        TickStats stats = atc.runSimulationTick();
+        totalMs += stats.totalMs;
+        if (stats.totalMs > worstMs) worstMs = stats.totalMs;
+
+        if (!quiet) {
+            cout << "TICK " << stats.tick << " airborne=" << stats.airborne
+                << " reached=" << stats.nodesReached << " landed=" << stats.arrivals
+                << " lowfuel=" << stats.lowFuelUpgrades
+                << " ms=" << stats.totalMs << " (advance " << stats.advanceMs
+                << ", apply " << stats.applyMs << ", queue " << stats.queueMs << ")" << endl;
+        }
+    }
+
+    if (!quiet && count > 1) {
+        cout << "TICKS " << count << " avg_ms=" << totalMs / count << " max_ms=" << worstMs << endl;
+    }
+}
+
+// EXPORT and IMPORT, with the text file names defaulting to flights.txt
+// and flightlog.txt.
+void ScriptRunner::runTextFiles(char* context, bool exporting) {
+    const char* flightsFile = strtok_s(nullptr, SCRIPT_DELIMS, &context);
+    const char* logFile = strtok_s(nullptr, SCRIPT_DELIMS, &context);
+    if (flightsFile == nullptr) flightsFile = "flights.txt";
+    if (logFile == nullptr) logFile = "flightlog.txt";
+
+    if (exporting) {
+        atc.exportText(flightsFile, logFile);
+        if (!quiet) cout << "EXPORTED " << flightsFile << " " << logFile << endl;
+    }
+    else {
+        atc.importText(flightsFile, logFile);
+        if (!quiet) cout << "IMPORTED " << flightsFile << " " << logFile << endl;
+    }
+}
+
+// The text report goes to stdout even in quiet mode: it was asked for.
+void ScriptRunner::runMetrics(char* context) {
+    char* path = strtok_s(nullptr, SCRIPT_DELIMS, &context);
+    if (path == nullptr) {
+        metrics().writeText(cout);
+        return;
+    }
+
+    ofstream file(path);
+    if (!file.is_open()) {
+        throw FileException(path);
+    }
+    metrics().writePrometheus(file);
+    if (!quiet) cout << "METRICS " << path << endl;
+}
@@ -0,0 +1,58 @@
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+
+#include "ATCSystem.h"
+#include <iostream>
+
+// Headless driver for ATCSystem. Reads one command per line, runs it through
+// the same core operations the menu uses and never clears the screen or
+// waits for input, so scenarios can be replayed from a file or a pipe.
+//
+//   ADD <id> <model> <fuel> <origin> <dest> <priority> <node>
+//   MOVE <id> <node>
+//   EMERGENCY <id> <type>         1=medical 2=engine 3=hijack 4=low fuel
+//   LAND
+//   SEARCH <id>
+//   ROUTE <id>
+//   LOG RANGE <from> <to>         log entries with from <= timestamp <= to
+//   LOG LAST <n>                  the n most recent log entries
+//   LOG PAGE <page> <size>        one page of the log in timestamp order, from 0
+//   LOG FLIGHT <id>               every log entry for one flight, in timestamp order
+//   TICK [count]                  advance the simulation, one timing line per tick
+//   METRICS [file]                latency/counter report; with a file, Prometheus format
+//   SAVE                          snapshot (state.bin) or journal append
+//   LOAD
+//   EXPORT [flights] [log]        text files, default flights.txt flightlog.txt
+//   IMPORT [flights] [log]
+//
+// Blank lines and lines starting with '#' are skipped. A failing command is
+// reported with its line number and the script carries on.
+class ScriptRunner {
+private:
+    ATCSystem& atc;
+    bool quiet;
+    long long executed;
+    long long failed;
+    double elapsedSeconds;
+
+    void execute(char* line);
+    void runAdd(char* context);
+    void runMove(char* context);
+    void runEmergency(char* context);
+    void runLand();
+    void runSearch(char* context);
+    void runRoute(char* context);
+    void runLog(char* context);
+    void runTick(char* context);
+    void runMetrics(char* context);
+    void runTextFiles(char* context, bool exporting);
+
+public:
+    ScriptRunner(ATCSystem& system, bool quietMode);
+    void run(std::istream& input);
+    void printSummary(std::ostream& out) const;
+    long long getExecutedCount() const;
+    long long getFailedCount() const;
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include "Simulation.h"
+#include "Utilities.h"
+#include "Exceptions.h"
+#include "Metrics.h"
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+static double millisecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void resetCounts(TickStats& stats) {
+    stats.airborne = 0;
+    stats.nodesReached = 0;
+    stats.arrivals = 0;
+    stats.lowFuelUpgrades = 0;
+}
+
+SimulationEngine::SimulationEngine(const Graph& graph, HashTable& registry, MinHeap& landingQueue,
+    FlightLog& flightLog, int threadCount)
+    : graph(graph), registry(registry), landingQueue(landingQueue), flightLog(flightLog),
+    routedNodes(-1), routedEdges(-1), pool(nullptr), tickCount(0) {
+    setThreadCount(threadCount);
+}
+
+SimulationEngine::~SimulationEngine() {
+    delete pool;
+}
+
+long long SimulationEngine::getTickCount() const {
+    return tickCount;
+}
+
+// 0 means one thread per hardware core.
+void SimulationEngine::setThreadCount(int threadCount) {
+    ThreadPool* replacement = new(nothrow) ThreadPool(threadCount);
+    if (replacement == nullptr) {
+        throw MemoryAllocationException();
+    }
+    delete pool;
+    pool = replacement;
+}
+
+int SimulationEngine::getThreadCount() const {
+    return pool->getThreadCount();
+}
+
+// (Re)builds the per-airport route tables when the graph has changed since
+// the last tick. Graphs only grow, so node and edge counts are enough.
+void SimulationEngine::prepareRoutes() {
+    int n = graph.getNodeCount();
+    if (n == routedNodes && graph.getEdgeCount() == routedEdges) {
+        return;
+    }
+
+    routeRow.clear();
+    routeRow.resize(n, -1);
+    airportNodes.clear();
+    nearestAirport.clear();
+    nearestAirport.resize(n, -1);
+
+    int airports = 0;
+    for (int i = 0; i < n; i++) {
+        if (graph.getIsAirport(i)) {
+            routeRow[i] = airports++;
+            airportNodes.pushBack(i);
+        }
+        nearestAirport[i] = graph.getNearestAirport(i);
+    }
+
+    routeNextHop.clear();
+    routeNextHop.resize(airports * n, -1);
+    routeDist.clear();
+    routeDist.resize(airports * n, INF);
+
+    DynamicArray<int> dist, nextHop;
+    for (int i = 0; i < n; i++) {
+        if (routeRow[i] == -1) continue;
+        graph.buildRouteTable(i, dist, nextHop);
+        int base = routeRow[i] * n;
+        for (int v = 0; v < n; v++) {
+            routeNextHop[base + v] = nextHop[v];
+            routeDist[base + v] = dist[v];
+        }
+    }
+
+    // Tracks hold route state for the old graph.
+    tracks.clear();
+    routedNodes = n;
+    routedEdges = graph.getEdgeCount();
+}
+
+// The destination airport when it exists in the graph and can be reached,
+// otherwise the nearest airport.
+int SimulationEngine::resolveTarget(int handle) const {
+    const AircraftStore& store = registry.getStore();
+    int n = routedNodes;
+    int node = store.graphNode(handle);
+    if (node < 0 || node >= n) {
+        return -1;
+    }
+
+    // Only airports can be destinations, so there is no need to search
+    // every node by name.
+    for (int i = 0; i < airportNodes.getSize(); i++) {
+        int dest = airportNodes[i];
+        if (strcmp(graph.getNodeName(dest), store.getDetails(handle).destination) == 0) {
+            if (routeDist[routeRow[dest] * n + node] < INF) {
+                return dest;
+            }
+            break;
+        }
+    }
+    return nearestAirport[node];
+}
+
+void SimulationEngine::resetTrack(FlightTrack& track, int handle) const {
+    const AircraftStore& store = registry.getStore();
+    track.generation = store.generation(handle);
+    track.node = store.graphNode(handle);
+    track.target = resolveTarget(handle);
+    track.progress = 0;
+}
+
+// Advances one aircraft by a tick, after the fuel sweep. Only the aircraft's
+// own record and track are written; anything shared is queued in out.
+void SimulationEngine::advance(int handle, DynamicArray<SimEvent>& out, TickStats& stats) {
+    AircraftStore& store = registry.getStore();
+    int n = routedNodes;
+    FlightTrack& track = tracks[handle];
+    if (track.generation != store.generation(handle) || track.node != store.graphNode(handle)
+        || track.target == -2) {
+        resetTrack(track, handle);
+    }
+
+    if (store.fuelLevel(handle) < 10 && store.priority(handle) > 2) {
+        store.priority(handle) = 2;
+        stats.lowFuelUpgrades++;
+        if (track.node >= 0 && track.node < n && nearestAirport[track.node] != -1
+            && nearestAirport[track.node] != track.target) {
+            track.target = nearestAirport[track.node];
+            track.progress = 0;
+        }
+    }
+
+    if (track.target < 0) {
+        return;  // holding: no airport reachable from here
+    }
+
+    int row = routeRow[track.target] * n;
+    int node = track.node;
+    int next = routeNextHop[row + node];
+
+    if (node != track.target && next != -1) {
+        track.progress += SIM_AIRSPEED;
+        int leg = routeDist[row + node] - routeDist[row + next];
+        while (next != -1 && track.progress >= leg) {
+            track.progress -= leg;
+            node = next;
+            stats.nodesReached++;
+            if (node == track.target) {
+                track.progress = 0;
+                break;
+            }
+            next = routeNextHop[row + node];
+            if (next != -1) {
+                leg = routeDist[row + node] - routeDist[row + next];
+            }
+        }
+        track.node = node;
+
+        int x = graph.getNodeX(node);
+        int y = graph.getNodeY(node);
+        if (node != track.target && next != -1 && leg > 0) {
+            x += (graph.getNodeX(next) - x) * track.progress / leg;
+            y += (graph.getNodeY(next) - y) * track.progress / leg;
+        }
+
+        if (node != store.graphNode(handle) || x != store.gridX(handle) || y != store.gridY(handle)) {
+            SimEvent move;
+            move.handle = handle;
+            move.type = SIM_EVENT_MOVE;
+            move.node = node;
+            move.x = x;
+            move.y = y;
+            out.pushBack(move);
+        }
+    }
+
+    if (node == track.target) {
+        SimEvent arrive;
+        arrive.handle = handle;
+        arrive.type = SIM_EVENT_ARRIVE;
+        arrive.node = node;
+        arrive.x = graph.getNodeX(node);
+        arrive.y = graph.getNodeY(node);
+        out.pushBack(arrive);
+    }
+}
+
+void SimulationEngine::applyEvents(const DynamicArray<SimEvent>& pending, TickStats& stats) {
+    int now = getCurrentTimestamp();
+
+    for (int i = 0; i < pending.getSize(); i++) {
+        const SimEvent& e = pending[i];
+        if (e.type == SIM_EVENT_MOVE) {
+            registry.updatePosition(e.handle, e.node, e.x, e.y);
+            continue;
+        }
+
+        registry.updatePosition(e.handle, e.node, e.x, e.y);
+        registry.markLanded(e.handle);
+        landingQueue.removeHandle(e.handle);
+        tracks[e.handle].target = -2;
+
+        flightLog.insert(e.handle, now, "LANDED");
+        stats.arrivals++;
+    }
+}
+
+TickStats SimulationEngine::tick() {
+    METRIC_TIMER(OP_SIMULATION_TICK);
+    auto start = chrono::steady_clock::now();
+
+    TickStats stats;
+    stats.tick = ++tickCount;
+    resetCounts(stats);
+
+    prepareRoutes();
+
+    AircraftStore& store = registry.getStore();
+    int limit = store.getHandleLimit();
+    if (tracks.getSize() < limit) {
+        FlightTrack fresh;
+        fresh.generation = 0;
+        fresh.node = -1;
+        fresh.target = -2;
+        fresh.progress = 0;
+        tracks.resize(limit, fresh);
+    }
+
+    int parts = 1;
+    if (limit >= SIM_PARALLEL_MIN_HANDLES) {
+        parts = pool->getThreadCount() * SIM_PARTITIONS_PER_THREAD;
+    }
+    if (partEvents.getSize() < parts) {
+        partEvents.resize(parts);
+        partStats.resize(parts);
+    }
+    int span = (limit + parts - 1) / parts;
+
+    pool->run(parts, [&](int p) {
+        DynamicArray<SimEvent>& out = partEvents[p];
+        TickStats& local = partStats[p];
+        out.clear();
+        resetCounts(local);
+
+        int begin = p * span;
+        int end = begin + span < limit ? begin + span : limit;
+
+        // Fuel burn is a branch-free pass over two contiguous columns, which
+        // the compiler can vectorize; landed and free records are unchanged.
+        int* fuel = store.fuelData();
+        const unsigned char* inAir = store.inAirData();
+        for (int h = begin; h < end; h++) {
+            int burned = fuel[h] - SIM_FUEL_BURN_PER_TICK * inAir[h];
+            fuel[h] = (burned < 0 && inAir[h]) ? 0 : burned;
+        }
+
+        for (int h = begin; h < end; h++) {
+            if (!inAir[h]) continue;
+            local.airborne++;
+            advance(h, out, local);
+        }
+    });
+    stats.advanceMs = millisecondsSince(start);
+
+    auto applyStart = chrono::steady_clock::now();
+    for (int p = 0; p < parts; p++) {
+        stats.airborne += partStats[p].airborne;
+        stats.nodesReached += partStats[p].nodesReached;
+        stats.lowFuelUpgrades += partStats[p].lowFuelUpgrades;
+        applyEvents(partEvents[p], stats);
+    }
+    stats.applyMs = millisecondsSince(applyStart);
+    METRIC_ADD(CTR_FLIGHTS_LANDED, stats.arrivals);
+    METRIC_ADD(CTR_LOW_FUEL_UPGRADES, stats.lowFuelUpgrades);
+
+    auto queueStart = chrono::steady_clock::now();
+    landingQueue.rekeyAll();
+    stats.queueMs = millisecondsSince(queueStart);
+
+    stats.totalMs = millisecondsSince(start);
+    return stats;
+}
@@ -0,0 +1,104 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Constants.h"
+#include "Aircraft.h"
+#include "Graph.h"
+#include "HashTable.h"
+#include "MinHeap.h"
+#include "FlightLog.h"
+#include "DynamicArray.h"
+#include "ThreadPool.h"
+
+// Counts and timings (milliseconds) for one SimulationEngine::tick().
+struct TickStats {
+    long long tick;
+    int airborne;
+    int nodesReached;
+    int arrivals;
+    int lowFuelUpgrades;
+    double advanceMs;   // flying every aircraft along its route
+    double applyMs;     // occupancy updates, landings and log inserts
+    double queueMs;     // re-keying the landing queue
+    double totalMs;
+};
+
+// Route state for one registry handle. generation and node identify the
+// aircraft the track was built for, so a recycled handle or a manual move
+// starts a fresh track.
+struct FlightTrack {
+    unsigned int generation;
+    int node;           // last graph node reached
+    int target;         // airport being flown to, -1 when none is reachable,
+                        // -2 when the track must be rebuilt
+    int progress;       // distance flown from node toward the next hop
+};
+
+enum SimEventType {
+    SIM_EVENT_MOVE,
+    SIM_EVENT_ARRIVE
+};
+
+// Change produced while advancing one aircraft. Events touch shared
+// structures (occupancy index, landing queue, flight log), so they are
+// applied after the advance pass, in handle order.
+struct SimEvent {
+    int handle;
+    int type;
+    int node;
+    int x, y;
+};
+
+// Fixed-step simulation of all airborne aircraft. Every tick each aircraft
+// flies SIM_AIRSPEED along the shortest route to its destination airport
+// (or the nearest airport when the destination is not one), burns fuel,
+// gets the low-fuel priority upgrade and diverts to the nearest airport
+// when fuel drops below 10, and lands into the flight log on arrival.
+//
+// Routes come from one reverse Dijkstra per airport, so moving an aircraft
+// is a table lookup rather than a search.
+//
+// The advance pass splits the registry's handle range into contiguous
+// partitions that run on a thread pool. Each partition collects its own
+// events and counts; they are merged in partition order, so the result is
+// the same as a single-threaded tick.
+class SimulationEngine {
+private:
+    const Graph& graph;
+    HashTable& registry;
+    MinHeap& landingQueue;
+    FlightLog& flightLog;
+
+    DynamicArray<FlightTrack> tracks;
+    DynamicArray<int> routeRow;       // airport node -> row in the route tables, -1 otherwise
+    DynamicArray<int> routeNextHop;   // one row of nodeCount entries per airport
+    DynamicArray<int> routeDist;
+    DynamicArray<int> nearestAirport;
+    DynamicArray<int> airportNodes;
+    int routedNodes;
+    int routedEdges;
+
+    ThreadPool* pool;
+    DynamicArray<DynamicArray<SimEvent> > partEvents;
+    DynamicArray<TickStats> partStats;
+    long long tickCount;
+
+    void prepareRoutes();
+    int resolveTarget(int handle) const;
+    void resetTrack(FlightTrack& track, int handle) const;
+    void advance(int handle, DynamicArray<SimEvent>& out, TickStats& stats);
+    void applyEvents(const DynamicArray<SimEvent>& pending, TickStats& stats);
+
+public:
+    SimulationEngine(const Graph& graph, HashTable& registry, MinHeap& landingQueue,
+        FlightLog& flightLog, int threadCount = 0);
+    ~SimulationEngine();
+    SimulationEngine(const SimulationEngine&) = delete;
+    SimulationEngine& operator=(const SimulationEngine&) = delete;
+    TickStats tick();
+    long long getTickCount() const;
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+#include "Exceptions.h"
+#include "Platform.h"
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+// Four independent multiply-rotate lanes over 32-byte blocks, so the
+// checksum runs at memory speed; the tail is folded in byte by byte.
+class SnapshotChecksum {
+private:
+    static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+
+    uint64_t lanes[4];
+    unsigned char carry[32];
+    size_t carried;
+    uint64_t total;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    void block(const unsigned char* p) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t word;
+            memcpy(&word, p + i * 8, 8);
+            lanes[i] = rotl(lanes[i] + word * PRIME2, 31) * PRIME1;
+        }
+    }
+
+public:
+    SnapshotChecksum() : carried(0), total(0) {
+        lanes[0] = PRIME1 + PRIME2;
+        lanes[1] = PRIME2;
+        lanes[2] = 0;
+        lanes[3] = 0 - PRIME1;
+    }
+
+    void update(const void* data, size_t size) {
+        const unsigned char* p = (const unsigned char*)data;
+        total += size;
+        if (carried > 0) {
+            size_t take = 32 - carried < size ? 32 - carried : size;
+            memcpy(carry + carried, p, take);
+            carried += take;
+            p += take;
+            size -= take;
+            if (carried < 32) return;
+            block(carry);
+            carried = 0;
+        }
+        while (size >= 32) {
+            block(p);
+            p += 32;
+            size -= 32;
+        }
+        memcpy(carry, p, size);
+        carried = size;
+    }
+
+    uint64_t finish() const {
+        uint64_t h = total * PRIME1;
+        for (int i = 0; i < 4; i++) {
+            h = rotl(h ^ (lanes[i] * PRIME2), 27) * PRIME1;
+        }
+        for (size_t i = 0; i < carried; i++) {
+            h = rotl(h ^ (carry[i] * PRIME1), 11) * PRIME2;
+        }
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        return h;
+    }
+};
+
+static uint64_t alignTo8(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// Buffers the header and records and writes them in large blocks, folding
+// every byte into the checksum.
+class SnapshotWriter {
+private:
+    ofstream& file;
+    SnapshotChecksum checksum;
+    string buffer;
+    uint64_t written;
+
+public:
+    explicit SnapshotWriter(ofstream& file) : file(file), written(0) {
+        buffer.reserve(1 << 20);
+    }
+
+    void write(const void* data, size_t size) {
+        checksum.update(data, size);
+        buffer.append((const char*)data, size);
+        written += size;
+        if (buffer.size() >= (1 << 20)) flush();
+    }
+
+    void padTo8() {
+        static const char zeros[8] = { 0 };
+        size_t pad = (size_t)(alignTo8(written) - written);
+        if (pad > 0) write(zeros, pad);
+    }
+
+    void flush() {
+        file.write(buffer.data(), (streamsize)buffer.size());
+        buffer.clear();
+    }
+
+    uint64_t getChecksum() const { return checksum.finish(); }
+};
+
+template <size_t N>
+static void copyField(char (&dest)[N], const char* src) {
+    memset(dest, 0, N);
+    size_t len = strlen(src);
+    memcpy(dest, src, len < N - 1 ? len : N - 1);
+}
+
+template <size_t N, size_t M>
+static void readField(char (&dest)[N], const char (&src)[M]) {
+    static_assert(N >= M, "destination field too small");
+    memcpy(dest, src, M);
+    dest[M - 1] = '\0';
+}
+
+static void readFlight(const SnapshotFlight& record, Aircraft& a) {
+    readField(a.flightID, record.flightID);
+    readField(a.model, record.model);
+    readField(a.origin, record.origin);
+    readField(a.destination, record.destination);
+    a.fuelLevel = record.fuelLevel;
+    a.priority = record.priority;
+    a.gridX = record.gridX;
+    a.gridY = record.gridY;
+    a.graphNode = record.graphNode;
+    a.inAir = record.inAir != 0;
+    a.timestamp = record.timestamp;
+}
+
+void saveSnapshot(const char* filename, const HashTable& registry, const FlightLog& flightLog,
+    uint32_t generation) {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    // Flights go out in handle order, which keeps a reloaded store in the
+    // same order as the one that was saved.
+    const AircraftStore& store = registry.getStore();
+    DynamicArray<int> handles;
+    registry.getHandles(handles);
+    DynamicArray<unsigned char> registered;
+    registered.resize(store.getHandleLimit(), 0);
+    for (int i = 0; i < handles.getSize(); i++) {
+        registered[handles[i]] = 1;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.flightRecordSize = sizeof(SnapshotFlight);
+    header.logRecordSize = sizeof(SnapshotLogEntry);
+    header.generation = generation;
+    header.checksum = 0;
+    header.flightCount = (uint64_t)handles.getSize();
+    header.flightOffset = alignTo8(sizeof(SnapshotHeader));
+    header.logCount = (uint64_t)flightLog.getCount();
+    header.logOffset = alignTo8(header.flightOffset + header.flightCount * sizeof(SnapshotFlight));
+
+    string tempName = string(filename) + ".tmp";
+    ofstream file(tempName.c_str(), ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw FileException(tempName.c_str());
+    }
+
+    try {
+        // The header goes through the checksum with its checksum field 0.
+        SnapshotWriter writer(file);
+        writer.write(&header, sizeof(header));
+        writer.padTo8();
+
+        for (int h = 0; h < store.getHandleLimit(); h++) {
+            if (!registered[h]) continue;
+            const AircraftDetails& d = store.getDetails(h);
+            SnapshotFlight record;
+            memset(&record, 0, sizeof(record));
+            record.fuelLevel = store.fuelLevel(h);
+            record.priority = store.priority(h);
+            record.gridX = store.gridX(h);
+            record.gridY = store.gridY(h);
+            record.graphNode = store.graphNode(h);
+            record.timestamp = store.timestamp(h);
+            copyField(record.flightID, d.flightID);
+            copyField(record.model, d.model);
+            copyField(record.origin, d.origin);
+            copyField(record.destination, d.destination);
+            record.inAir = store.inAir(h) ? 1 : 0;
+            writer.write(&record, sizeof(record));
+        }
+        writer.padTo8();
+
+        for (LogCursor entry = flightLog.fromRank(0, flightLog.getCount()); entry.isValid(); entry.next()) {
+            SnapshotLogEntry record;
+            memset(&record, 0, sizeof(record));
+            record.timestamp = entry.timestamp();
+            copyField(record.flightID, entry.flightID());
+            copyField(record.origin, entry.origin());
+            copyField(record.destination, entry.destination());
+            copyField(record.status, entry.status());
+            writer.write(&record, sizeof(record));
+        }
+        writer.flush();
+
+        header.checksum = writer.getChecksum();
+        file.seekp(0);
+        file.write((const char*)&header, sizeof(header));
+        file.close();
+        if (file.fail() || !syncFile(tempName.c_str())) {
+            throw FileException(tempName.c_str());
+        }
+    }
+    catch (...) {
+        file.close();
+        remove(tempName.c_str());
+        throw;
+    }
+
+    if (!replaceFile(tempName.c_str(), filename)) {
+        throw FileException(filename);
+    }
+}
+
+bool loadSnapshot(const char* filename, HashTable& registry, FlightLog& flightLog,
+    uint32_t* generation) {
+    if (filename == nullptr || strlen(filename) == 0) {
+        throw FileException("Invalid filename");
+    }
+
+    MappedFile mapped;
+    if (!mapped.open(filename)) {
+        return false;
+    }
+    const unsigned char* base = mapped.data();
+    uint64_t size = mapped.size();
+
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        throw SnapshotFormatException(filename, "truncated header");
+    }
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw SnapshotFormatException(filename, "not a snapshot file");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw SnapshotFormatException(filename, "unsupported version");
+    }
+    if (header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        throw SnapshotFormatException(filename, "written with a different byte order");
+    }
+    if (header.headerSize != sizeof(SnapshotHeader) || header.flightRecordSize != sizeof(SnapshotFlight)
+        || header.logRecordSize != sizeof(SnapshotLogEntry)) {
+        throw SnapshotFormatException(filename, "record layout mismatch");
+    }
+    if (header.flightOffset % 8 != 0 || header.logOffset % 8 != 0
+        || header.flightOffset < header.headerSize || header.flightCount > INT32_MAX
+        || header.logCount > INT32_MAX
+        || header.flightOffset + header.flightCount * sizeof(SnapshotFlight) > header.logOffset
+        || header.logOffset + header.logCount * sizeof(SnapshotLogEntry) > size) {
+        throw SnapshotFormatException(filename, "sections out of bounds");
+    }
+
+    SnapshotHeader unsummed = header;
+    unsummed.checksum = 0;
+    SnapshotChecksum checksum;
+    checksum.update(&unsummed, sizeof(unsummed));
+    checksum.update(base + header.headerSize, (size_t)(size - header.headerSize));
+    if (checksum.finish() != header.checksum) {
+        throw SnapshotFormatException(filename, "checksum mismatch");
+    }
+
+    int flightCount = (int)header.flightCount;
+    const SnapshotFlight* flights = (const SnapshotFlight*)(base + header.flightOffset);
+    if (registry.getCount() == 0) {
+        // Cold start: a valid snapshot holds each flight ID once, so the
+        // records go straight into fresh store handles in file order and
+        // the registry indexes the whole range in one pass.
+        AircraftStore& store = registry.getStore();
+        int first = store.allocateRange(flightCount);
+        for (int i = 0; i < flightCount; i++) {
+            Aircraft a;
+            readFlight(flights[i], a);
+            if (strlen(a.flightID) == 0) {
+                for (int h = first; h < first + flightCount; h++) {
+                    store.release(h);
+                }
+                throw SnapshotFormatException(filename, "empty flight ID");
+            }
+            store.set(first + i, a);
+        }
+        registry.adoptRange(first, flightCount);
+    }
+    else {
+        registry.reserve(flightCount);
+        for (int i = 0; i < flightCount; i++) {
+            Aircraft a;
+            readFlight(flights[i], a);
+            if (strlen(a.flightID) == 0 || registry.exists(a.flightID)) {
+                continue;
+            }
+            registry.insert(a);
+        }
+    }
+
+    // The log section is in timestamp order, so every entry takes the
+    // log's append path.
+    const SnapshotLogEntry* records = (const SnapshotLogEntry*)(base + header.logOffset);
+    flightLog.reserve((int)header.logCount);
+    for (int i = 0; i < (int)header.logCount; i++) {
+        const SnapshotLogEntry& record = records[i];
+        char flightID[20], origin[20], destination[20], status[20];
+        readField(flightID, record.flightID);
+        readField(origin, record.origin);
+        readField(destination, record.destination);
+        readField(status, record.status);
+        if (strlen(flightID) == 0 || strlen(status) == 0) {
+            throw SnapshotFormatException(filename, "empty log entry");
+        }
+        flightLog.insert(record.timestamp, flightID, origin, destination, status);
+    }
+    if (generation != nullptr) {
+        *generation = header.generation;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "HashTable.h"
+#include "FlightLog.h"
+#include <cstdint>
+
+// Binary snapshot of the registry and the flight log (state.bin).
+//
+// Layout: a fixed header, then flightCount SnapshotFlight records at
+// flightOffset, then logCount SnapshotLogEntry records at logOffset, both
+// sections 8-byte aligned. Log entries are stored in timestamp order. The
+// header records the format version, the byte order and record sizes it was
+// written with, and a checksum over the whole file, header included with its
+// checksum field taken as 0; a file that fails any of these checks is
+// rejected rather than partially loaded.
+//
+// Records are fixed size, so the file is read through a memory mapping. On a
+// cold start (empty registry) the flights are copied into the store in one
+// pass and the registry and its occupancy index are built over them in bulk;
+// merging into a non-empty registry inserts them one by one. The
+// pipe-delimited text files remain available for import and export.
+
+const char SNAPSHOT_MAGIC[8] = { 'S', 'K', 'Y', 'N', 'E', 'T', 'S', 'S' };
+const std::uint32_t SNAPSHOT_VERSION = 2;
+const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t headerSize;
+    std::uint32_t flightRecordSize;
+    std::uint32_t logRecordSize;
+    std::uint32_t generation;   // matches the journal written on top of it
+    std::uint64_t flightCount;
+    std::uint64_t flightOffset;
+    std::uint64_t logCount;
+    std::uint64_t logOffset;
+    std::uint64_t checksum;
+};
+
+struct SnapshotFlight {
+    std::int32_t fuelLevel;
+    std::int32_t priority;
+    std::int32_t gridX;
+    std::int32_t gridY;
+    std::int32_t graphNode;
+    std::int32_t timestamp;
+    char flightID[20];
+    char model[30];
+    char origin[20];
+    char destination[20];
+    std::uint8_t inAir;
+    std::uint8_t reserved;
+};
+
+struct SnapshotLogEntry {
+    std::int32_t timestamp;
+    char flightID[20];
+    char origin[20];
+    char destination[20];
+    char status[20];
+};
+
+static_assert(sizeof(SnapshotHeader) == 72, "snapshot header layout changed");
+static_assert(sizeof(SnapshotFlight) == 116, "snapshot flight record layout changed");
+static_assert(sizeof(SnapshotLogEntry) == 84, "snapshot log record layout changed");
+
+// Writes to filename.tmp, syncs it to disk and renames it over filename, so
+// an interrupted save or a crash leaves either the previous snapshot or the
+// complete new one.
+void saveSnapshot(const char* filename, const HashTable& registry, const FlightLog& flightLog,
+    std::uint32_t generation = 0);
+
+// Adds the snapshot's flights (skipping IDs already registered) and log
+// entries, and stores the header's generation when asked. Returns false when
+// the file does not exist; throws SnapshotFormatException when it is not a
+// valid snapshot.
+bool loadSnapshot(const char* filename, HashTable& registry, FlightLog& flightLog,
+    std::uint32_t* generation = nullptr);
+
+#endif
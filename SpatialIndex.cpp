@@ -0,0 +1,304 @@
+#include "SpatialIndex.h"
+#include "Exceptions.h"
+#include <new>
+
+using namespace std;
+
+SpatialIndex::SpatialIndex(int cellSize) : cellSize(cellSize), cells(nullptr), capacity(0), occupied(0) {
+    if (cellSize < 1) {
+        throw OutOfRangeException("Spatial index cell size");
+    }
+    rehash(64);
+}
+
+SpatialIndex::~SpatialIndex() {
+    delete[] cells;
+}
+
+int SpatialIndex::getCellSize() const { return cellSize; }
+
+long long SpatialIndex::cellKey(int cellX, int cellY) {
+    return ((long long)cellY << 32) | (unsigned int)cellX;
+}
+
+// First slot probed for key: a murmur3-finalized hash of it.
+int SpatialIndex::homeSlot(long long key) const {
+    unsigned long long h = (unsigned long long)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return (int)(h & (capacity - 1));
+}
+
+// Slot holding key, or the empty slot where it would go. Linear probing.
+int SpatialIndex::findSlot(long long key) const {
+    int mask = capacity - 1;
+    int index = homeSlot(key);
+    while (cells[index].key != -1 && cells[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// Rebuilds the cell table at newCapacity (a power of two), dropping cells
+// that have emptied since the last rebuild.
+void SpatialIndex::rehash(int newCapacity) {
+    SpatialCell* newCells = new(nothrow) SpatialCell[newCapacity];
+    if (newCells == nullptr) {
+        throw MemoryAllocationException();
+    }
+    for (int i = 0; i < newCapacity; i++) {
+        newCells[i].key = -1;
+        newCells[i].head = -1;
+    }
+    SpatialCell* oldCells = cells;
+    int oldCapacity = capacity;
+    cells = newCells;
+    capacity = newCapacity;
+    occupied = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldCells[i].head != -1) {
+            cells[findSlot(oldCells[i].key)] = oldCells[i];
+            occupied++;
+        }
+    }
+    delete[] oldCells;
+}
+
+// Makes room for one more cell. Emptied cells keep their slot until here,
+// so a handle moving back and forth between cells never deletes from the
+// table. The table only doubles when it is still over a quarter full once
+// they are dropped, which keeps the rebuilds amortized O(1) per new cell.
+void SpatialIndex::makeRoom() {
+    int live = 0;
+    for (int i = 0; i < capacity; i++) {
+        if (cells[i].head != -1) live++;
+    }
+    int newCapacity = capacity;
+    if (live * 4 > capacity) {
+        if (capacity > (1 << 29)) {
+            throw MemoryAllocationException();
+        }
+        newCapacity = capacity * 2;
+    }
+    rehash(newCapacity);
+}
+
+void SpatialIndex::ensureHandle(int handle) {
+    if (handle >= indexed.getSize()) {
+        nextInCell.resize(handle + 1, -1);
+        prevInCell.resize(handle + 1, -1);
+        indexed.resize(handle + 1, 0);
+        posX.resize(handle + 1, 0);
+        posY.resize(handle + 1, 0);
+    }
+}
+
+// Sizes the per-handle arrays up front so a bulk load does not regrow them.
+void SpatialIndex::reserve(int handleCount) {
+    nextInCell.reserve(handleCount);
+    prevInCell.reserve(handleCount);
+    indexed.reserve(handleCount);
+    posX.reserve(handleCount);
+    posY.reserve(handleCount);
+}
+
+// Sizes the cell table for cellCount occupied cells, so a bulk load of
+// that many positions never rebuilds it.
+void SpatialIndex::reserveCells(int cellCount) {
+    int newCapacity = capacity;
+    while ((long long)cellCount * 2 > newCapacity) {
+        if (newCapacity > (1 << 29)) {
+            throw MemoryAllocationException();
+        }
+        newCapacity *= 2;
+    }
+    if (newCapacity > capacity) {
+        rehash(newCapacity);
+    }
+}
+
+// Pushes handle onto the front of the cell at its indexed position,
+// adding the cell when it is new.
+void SpatialIndex::link(int handle) {
+    long long key = cellKey(posX[handle] / cellSize, posY[handle] / cellSize);
+    int slot = findSlot(key);
+    if (cells[slot].key == -1) {
+        // Keep the load factor at or below one half.
+        if ((occupied + 1) * 2 > capacity) {
+            makeRoom();
+            slot = findSlot(key);
+        }
+        cells[slot].key = key;
+        cells[slot].head = -1;
+        occupied++;
+    }
+    pushHandle(slot, handle);
+}
+
+void SpatialIndex::pushHandle(int slot, int handle) {
+    indexed[handle] = 1;
+    prevInCell[handle] = -1;
+    nextInCell[handle] = cells[slot].head;
+    if (cells[slot].head != -1) {
+        prevInCell[cells[slot].head] = handle;
+    }
+    cells[slot].head = handle;
+}
+
+void SpatialIndex::unlink(int handle) {
+    if (prevInCell[handle] != -1) {
+        nextInCell[prevInCell[handle]] = nextInCell[handle];
+    }
+    else {
+        int slot = findSlot(cellKey(posX[handle] / cellSize, posY[handle] / cellSize));
+        cells[slot].head = nextInCell[handle];
+    }
+    if (nextInCell[handle] != -1) prevInCell[nextInCell[handle]] = prevInCell[handle];
+    indexed[handle] = 0;
+    nextInCell[handle] = prevInCell[handle] = -1;
+}
+
+void SpatialIndex::insert(int handle, int x, int y) {
+    if (handle < 0) {
+        throw InvalidInputException("Invalid handle for spatial index");
+    }
+    ensureHandle(handle);
+    if (indexed[handle]) {
+        unlink(handle);
+    }
+    // Positions off the grid are not tracked.
+    if (x < 0 || y < 0) return;
+
+    posX[handle] = x;
+    posY[handle] = y;
+    link(handle);
+}
+
+// Indexes every handle at (xs[handle], ys[handle]) at once, for a bulk
+// load into an empty index; otherwise it is a loop of insert. The handles
+// are counting-sorted by their cell's home slot and the cells laid out in
+// one sweep: created in home order, each cell lands on the first free slot
+// at or after its home, and a cell's later handles find it among the slots
+// placed since. Only cells that wrap past the end go through link.
+void SpatialIndex::insertAll(const DynamicArray<int>& handles, const int* xs, const int* ys) {
+    int n = handles.getSize();
+    int maxHandle = -1;
+    for (int i = 0; i < n; i++) {
+        if (handles[i] < 0) {
+            throw InvalidInputException("Invalid handle for spatial index");
+        }
+        if (handles[i] > maxHandle) maxHandle = handles[i];
+    }
+    if (n == 0) return;
+    if (occupied != 0) {
+        for (int i = 0; i < n; i++) {
+            insert(handles[i], xs[handles[i]], ys[handles[i]]);
+        }
+        return;
+    }
+    ensureHandle(maxHandle);
+    reserveCells(n);
+
+    DynamicArray<long long> keys;
+    DynamicArray<int> bucketEnd;
+    DynamicArray<int> order;
+    keys.resize(n);
+    bucketEnd.resize(capacity + 1, 0);
+    order.resize(n);
+
+    int placed = 0;
+    for (int i = 0; i < n; i++) {
+        int h = handles[i];
+        // Positions off the grid are not tracked.
+        if (xs[h] < 0 || ys[h] < 0) {
+            keys[i] = -1;
+            continue;
+        }
+        posX[h] = xs[h];
+        posY[h] = ys[h];
+        keys[i] = cellKey(xs[h] / cellSize, ys[h] / cellSize);
+        bucketEnd[homeSlot(keys[i]) + 1]++;
+        placed++;
+    }
+    for (int slot = 0; slot < capacity; slot++) {
+        bucketEnd[slot + 1] += bucketEnd[slot];
+    }
+    for (int i = 0; i < n; i++) {
+        if (keys[i] != -1) {
+            order[bucketEnd[homeSlot(keys[i])]++] = i;
+        }
+    }
+
+    int nextFree = 0;
+    for (int k = 0; k < placed; k++) {
+        int i = order[k];
+        int home = homeSlot(keys[i]);
+        int slot = home;
+        while (slot < nextFree && cells[slot].key != keys[i]) {
+            slot++;
+        }
+        if (slot >= capacity) {
+            link(handles[i]);
+            continue;
+        }
+        if (slot >= nextFree) {
+            cells[slot].key = keys[i];
+            cells[slot].head = -1;
+            occupied++;
+            nextFree = slot + 1;
+        }
+        pushHandle(slot, handles[i]);
+    }
+}
+
+void SpatialIndex::move(int handle, int x, int y) {
+    insert(handle, x, y);
+}
+
+void SpatialIndex::remove(int handle) {
+    if (contains(handle)) {
+        unlink(handle);
+    }
+}
+
+bool SpatialIndex::contains(int handle) const {
+    return handle >= 0 && handle < indexed.getSize() && indexed[handle];
+}
+
+void SpatialIndex::clear() {
+    for (int i = 0; i < capacity; i++) {
+        cells[i].key = -1;
+        cells[i].head = -1;
+    }
+    occupied = 0;
+    for (int h = 0; h < indexed.getSize(); h++) {
+        indexed[h] = 0;
+        nextInCell[h] = prevInCell[h] = -1;
+    }
+}
+
+int SpatialIndex::firstInCell(int cellX, int cellY) const {
+    if (cellX < 0 || cellY < 0) {
+        return -1;
+    }
+    return cells[findSlot(cellKey(cellX, cellY))].head;
+}
+
+int SpatialIndex::nextInSameCell(int handle) const {
+    return nextInCell[handle];
+}
+
+// First handle sitting exactly on (x, y), skipping excludeHandle.
+int SpatialIndex::findAt(int x, int y, int excludeHandle) const {
+    if (x < 0 || y < 0) return -1;
+    for (int h = firstInCell(x / cellSize, y / cellSize); h != -1; h = nextInCell[h]) {
+        if (h != excludeHandle && posX[h] == x && posY[h] == y) {
+            return h;
+        }
+    }
+    return -1;
+}
+
+int SpatialIndex::getX(int handle) const { return posX[handle]; }
+int SpatialIndex::getY(int handle) const { return posY[handle]; }
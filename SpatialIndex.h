@@ -0,0 +1,63 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "DynamicArray.h"
+
+// One occupied cell: its packed (cellX, cellY) key and first handle.
+struct SpatialCell {
+    long long key;      // -1 when the slot is unused
+    int head;           // -1 when the cell is empty
+};
+
+// Uniform grid over integer positions. Each cell keeps an intrusive doubly
+// linked list of the handles inside it, so insert, move and remove are O(1)
+// and listing a cell costs only its own occupants. With cellSize 1 a cell is
+// exactly one radar square.
+//
+// Only occupied cells are stored, in an open-addressing table keyed by cell
+// coordinates, so memory follows the number of occupied cells rather than
+// the extent of the airspace. A cell that empties stays in the table until
+// the next rebuild.
+class SpatialIndex {
+private:
+    int cellSize;
+    SpatialCell* cells;
+    int capacity;                   // power of two, load factor <= 1/2
+    int occupied;
+    DynamicArray<int> nextInCell;   // handle -> next handle in its cell
+    DynamicArray<int> prevInCell;   // handle -> previous handle in its cell
+    DynamicArray<unsigned char> indexed;
+    DynamicArray<int> posX, posY;   // handle -> indexed position
+
+    static long long cellKey(int cellX, int cellY);
+    int homeSlot(long long key) const;
+    int findSlot(long long key) const;
+    void rehash(int newCapacity);
+    void makeRoom();
+    void reserveCells(int cellCount);
+    void ensureHandle(int handle);
+    void link(int handle);
+    void pushHandle(int slot, int handle);
+    void unlink(int handle);
+
+public:
+    SpatialIndex(int cellSize = 1);
+    ~SpatialIndex();
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+    void reserve(int handleCount);
+    void insert(int handle, int x, int y);
+    void insertAll(const DynamicArray<int>& handles, const int* xs, const int* ys);
+    void move(int handle, int x, int y);
+    void remove(int handle);
+    bool contains(int handle) const;
+    void clear();
+    int getCellSize() const;
+    int firstInCell(int cellX, int cellY) const;
+    int nextInSameCell(int handle) const;
+    int findAt(int x, int y, int excludeHandle = -1) const;
+    int getX(int handle) const;
+    int getY(int handle) const;
+};
+
+#endif
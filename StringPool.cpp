@@ -0,0 +1,100 @@
+#include "StringPool.h"
+#include "Exceptions.h"
+#include "Hashing.h"
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+StringPool::StringPool() : slots(nullptr), capacity(64) {
+    slots = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        slots[i] = -1;
+    }
+}
+
+StringPool::~StringPool() {
+    delete[] slots;
+}
+
+// Slot holding value, or the empty slot where it would go. Linear probing.
+int StringPool::findSlot(const char* value, unsigned int hash) const {
+    int mask = capacity - 1;
+    int index = (int)(hash & mask);
+    while (slots[index] != -1) {
+        int id = slots[index];
+        if (hashes[id] == hash && strcmp(&text[offsets[id]], value) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// Doubles the slot table; ids and text stay where they are.
+void StringPool::grow() {
+    int newCapacity = capacity * 2;
+    int* newSlots = new(nothrow) int[newCapacity];
+    if (newSlots == nullptr) {
+        throw MemoryAllocationException();
+    }
+    for (int i = 0; i < newCapacity; i++) {
+        newSlots[i] = -1;
+    }
+    int mask = newCapacity - 1;
+    for (int id = 0; id < offsets.getSize(); id++) {
+        int index = (int)(hashes[id] & mask);
+        while (newSlots[index] != -1) {
+            index = (index + 1) & mask;
+        }
+        newSlots[index] = id;
+    }
+    delete[] slots;
+    slots = newSlots;
+    capacity = newCapacity;
+}
+
+int StringPool::intern(const char* value) {
+    if (value == nullptr) {
+        throw InvalidInputException("Null string for string pool");
+    }
+    unsigned int hash = hashFlightID(value);
+    int index = findSlot(value, hash);
+    if (slots[index] != -1) {
+        return slots[index];
+    }
+
+    // Keep the load factor at or below one half.
+    if ((offsets.getSize() + 1) * 2 > capacity) {
+        grow();
+        index = findSlot(value, hash);
+    }
+
+    int id = offsets.getSize();
+    int length = (int)strlen(value);
+    offsets.pushBack(text.getSize());
+    hashes.pushBack(hash);
+    text.resize(text.getSize() + length + 1);
+    memcpy(&text[offsets[id]], value, length + 1);
+    slots[index] = id;
+    return id;
+}
+
+// Id of value, or -1 when it was never interned.
+int StringPool::find(const char* value) const {
+    if (value == nullptr) return -1;
+    return slots[findSlot(value, hashFlightID(value))];
+}
+
+const char* StringPool::get(int id) const {
+    return &text[offsets[id]];
+}
+
+int StringPool::getCount() const {
+    return offsets.getSize();
+}
+
+long long StringPool::getMemoryBytes() const {
+    return (long long)text.getCapacity() + (long long)offsets.getCapacity() * sizeof(int)
+        + (long long)hashes.getCapacity() * sizeof(unsigned int) + (long long)capacity * sizeof(int);
+}
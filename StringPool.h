@@ -0,0 +1,34 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "DynamicArray.h"
+
+// Interns short, often repeated strings (airport codes, statuses) as dense
+// integer ids, so a record that repeats them stores 4 bytes per field
+// instead of a fixed char array. Each distinct string is kept once.
+// Pointers returned by get() are invalidated when intern() adds a string.
+class StringPool {
+private:
+    DynamicArray<char> text;        // NUL-terminated strings back to back
+    DynamicArray<int> offsets;      // id -> start in text
+    DynamicArray<unsigned int> hashes;  // id -> hash, to skip rehashing on growth
+    int* slots;                     // open addressing, id or -1
+    int capacity;
+
+    int findSlot(const char* value, unsigned int hash) const;
+    void grow();
+
+public:
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    int intern(const char* value);
+    int find(const char* value) const;
+    const char* get(int id) const;
+    int getCount() const;
+    long long getMemoryBytes() const;
+};
+
+#endif
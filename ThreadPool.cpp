@@ -0,0 +1,131 @@
+#include "ThreadPool.h"
+#include "Exceptions.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threadCount)
+    : job(nullptr), jobTasks(0), nextTask(0), pendingWorkers(0), generation(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = (int)thread::hardware_concurrency();
+        if (threadCount <= 0) threadCount = 1;
+    }
+
+    // Room for every worker first, so a started thread is never left
+    // without a slot; one that fails to start stops the ones before it.
+    workers.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; i++) {
+        thread* worker;
+        try {
+            worker = new(nothrow) thread(&ThreadPool::workerLoop, this);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+        if (worker == nullptr) {
+            stop();
+            throw MemoryAllocationException();
+        }
+        workers.pushBack(worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+// Wakes every worker to exit and joins them.
+void ThreadPool::stop() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (int i = 0; i < workers.getSize(); i++) {
+        workers[i]->join();
+        delete workers[i];
+    }
+    workers.clear();
+}
+
+int ThreadPool::getThreadCount() const {
+    return workers.getSize() + 1;
+}
+
+// Claims and runs tasks of the given job until none are left. A task that
+// throws records the exception and ends the job for every thread.
+void ThreadPool::drain(const function<void(int)>& task, int taskCount) {
+    try {
+        while (true) {
+            int i = nextTask.fetch_add(1);
+            if (i >= taskCount) break;
+            task(i);
+        }
+    }
+    catch (...) {
+        lock_guard<mutex> guard(lock);
+        if (!failure) failure = current_exception();
+        nextTask.store(taskCount);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    long long seen = 0;
+    while (true) {
+        const function<void(int)>* task;
+        int taskCount;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            task = job;
+            taskCount = jobTasks;
+        }
+
+        drain(*task, taskCount);
+
+        bool last;
+        {
+            lock_guard<mutex> guard(lock);
+            last = --pendingWorkers == 0;
+        }
+        if (last) done.notify_one();
+    }
+}
+
+void ThreadPool::run(int taskCount, const function<void(int)>& task) {
+    if (taskCount <= 0) return;
+
+    if (workers.isEmpty() || taskCount == 1) {
+        for (int i = 0; i < taskCount; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        job = &task;
+        jobTasks = taskCount;
+        nextTask.store(0);
+        pendingWorkers = workers.getSize();
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(task, taskCount);
+
+    // Every worker checks in once per job, even if it found nothing left to
+    // claim, so none can still be touching this job after we return.
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [&] { return pendingWorkers == 0; });
+    job = nullptr;
+    exception_ptr error = failure;
+    failure = nullptr;
+    guard.unlock();
+    if (error) {
+        rethrow_exception(error);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "DynamicArray.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+// Fixed set of worker threads that run batches of independent tasks. run()
+// hands out task indices 0..taskCount-1 through a shared counter, takes part
+// in the work itself and returns once every task has finished, so callers
+// can treat it like a parallel for loop. If a task throws, the rest of the
+// batch is skipped and run() rethrows the first exception on the calling
+// thread once every worker has let go of the batch.
+class ThreadPool {
+private:
+    DynamicArray<std::thread*> workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int)>* job;
+    int jobTasks;
+    std::atomic<int> nextTask;
+    int pendingWorkers;     // workers yet to finish the current job
+    long long generation;
+    bool stopping;
+    std::exception_ptr failure; // first exception thrown by the current job
+
+    void stop();
+    void workerLoop();
+    void drain(const std::function<void(int)>& task, int taskCount);
+
+public:
+    // threadCount includes the calling thread; 0 uses one per hardware core.
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void run(int taskCount, const std::function<void(int)>& task);
+    int getThreadCount() const;
+};
+
+#endif
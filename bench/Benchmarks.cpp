@@ -0,0 +1,1133 @@
+// Microbenchmarks for the core data structures.
+//
+// Every benchmark runs at each size in the sweep and is repeated; the best
+// and mean time per operation go to a JSON report that can be diffed
+// between builds. Setup work (filling a table before searching it, etc.) is
+// not timed. Benchmarks that stream a file also report MB/s.
+//
+// Usage:
+//   skynet_bench [--sizes 1000,10000,100000] [--system-sizes 10000,100000,1000000]
+//                [--threads 1,2,4] [--repeat n] [--filter text] [--out file]
+
+#include "ATCSystem.h"
+#include "HashTable.h"
+#include "MinHeap.h"
+#include "FlightLog.h"
+#include "Graph.h"
+#include "Radar.h"
+#include "SpatialIndex.h"
+#include "ConflictDetector.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "RecordReader.h"
+#include "DynamicArray.h"
+#include "Exceptions.h"
+#include "Metrics.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+// Results are folded into this so the optimizer cannot drop the work.
+static volatile long long benchSink = 0;
+
+class BenchRandom {
+private:
+    unsigned long long state;
+
+public:
+    explicit BenchRandom(unsigned long long seed) : state(seed) {}
+
+    unsigned long long next() {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    int below(int bound) {
+        return bound <= 0 ? 0 : (int)(next() % (unsigned long long)bound);
+    }
+};
+
+// Swallows console output while display-style routines are timed.
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+class SilenceCout {
+private:
+    NullBuffer sink;
+    streambuf* saved;
+
+public:
+    SilenceCout() : saved(cout.rdbuf(&sink)) {}
+    ~SilenceCout() { cout.rdbuf(saved); }
+};
+
+struct BenchResult {
+    string name;
+    int size;
+    long long ops;
+    long long bytes;
+    double bestSeconds;
+    double meanSeconds;
+    const char* statName;   // optional per-op statistic, e.g. nodes expanded
+    double statValue;
+};
+
+class BenchSuite {
+private:
+    DynamicArray<BenchResult> results;
+    string filter;
+    int repeats;
+
+public:
+    BenchSuite(const string& filterText, int repeatCount) : filter(filterText), repeats(repeatCount) {}
+
+    bool enabled(const char* name) const {
+        return filter.empty() || strstr(name, filter.c_str()) != nullptr;
+    }
+
+    // setup() runs before every repeat and is not timed; body() performs
+    // ops operations.
+    template <typename Setup, typename Body>
+    void measure(const char* name, int size, long long ops, Setup setup, Body body) {
+        measureBytes(name, size, ops, 0, setup, body);
+    }
+
+    // As measure(), for a body that also streams bytes of input.
+    template <typename Setup, typename Body>
+    void measureBytes(const char* name, int size, long long ops, long long bytes, Setup setup, Body body) {
+        if (!enabled(name)) return;
+
+        double best = 0.0, total = 0.0;
+        for (int r = 0; r < repeats; r++) {
+            setup();
+            auto start = chrono::steady_clock::now();
+            body();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            total += seconds;
+            if (r == 0 || seconds < best) best = seconds;
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.size = size;
+        result.ops = ops;
+        result.bytes = bytes;
+        result.bestSeconds = best;
+        result.meanSeconds = total / repeats;
+        result.statName = nullptr;
+        result.statValue = 0.0;
+        results.pushBack(result);
+
+        cerr << left << setw(34) << name << right << setw(9) << size
+            << setw(14) << fixed << setprecision(1) << best * 1e9 / ops << " ns/op";
+        if (bytes > 0) {
+            cerr << setw(12) << bytes / best / 1e6 << " MB/s";
+        }
+        cerr << endl;
+    }
+
+    // Best time per operation of the latest result under name, or 0 when
+    // that benchmark was filtered out.
+    double bestNsPerOp(const char* name) const {
+        for (int i = results.getSize() - 1; i >= 0; i--) {
+            if (results[i].name == name) return results[i].bestSeconds * 1e9 / results[i].ops;
+        }
+        return 0.0;
+    }
+
+    // Attaches a statistic to the result just measured under name; shown
+    // under its timing line and written as an extra JSON field.
+    void annotate(const char* name, const char* statName, double value) {
+        if (!enabled(name) || results.isEmpty() || results.back().name != name) return;
+        results.back().statName = statName;
+        results.back().statValue = value;
+        cerr << "  " << statName << " " << fixed << setprecision(1) << value << endl;
+    }
+
+    void writeJson(ostream& out) const {
+        out << "{\n  \"suite\": \"skynet_bench\",\n  \"repeats\": " << repeats << ",\n  \"results\": [\n";
+        for (int i = 0; i < results.getSize(); i++) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+                << ", \"ops\": " << r.ops << fixed << setprecision(2)
+                << ", \"best_ns_per_op\": " << r.bestSeconds * 1e9 / r.ops
+                << ", \"mean_ns_per_op\": " << r.meanSeconds * 1e9 / r.ops
+                << ", \"ops_per_sec\": " << setprecision(0) << r.ops / r.bestSeconds;
+            if (r.bytes > 0) {
+                out << ", \"mb_per_sec\": " << setprecision(1) << r.bytes / r.bestSeconds / 1e6;
+            }
+            if (r.statName != nullptr) {
+                out << ", \"" << r.statName << "\": " << setprecision(1) << r.statValue;
+            }
+            out << "}"
+                << (i + 1 < results.getSize() ? "," : "") << "\n";
+        }
+        out << "  ]\n}" << endl;
+    }
+};
+
+// ---------------------------------------------------------------- fixtures
+
+struct FlightKey {
+    char id[20];
+};
+
+static void makeKeys(int count, const char* prefix, DynamicArray<FlightKey>& keys) {
+    keys.resize(count);
+    for (int i = 0; i < count; i++) {
+        snprintf(keys[i].id, sizeof(keys[i].id), "%s%d", prefix, i);
+    }
+}
+
+static Aircraft makeAircraft(const char* id, BenchRandom& rng, int width, int height) {
+    Aircraft a;
+    a.setFlightID(id);
+    a.setModel("A320");
+    a.setOrigin("AAA");
+    a.setDestination("AAB");
+    a.fuelLevel = 10 + rng.below(91);
+    a.priority = 1 + rng.below(4);
+    a.gridX = rng.below(width);
+    a.gridY = rng.below(height);
+    a.graphNode = 0;
+    a.inAir = true;
+    a.timestamp = 1700000000 + rng.below(1000000);
+    return a;
+}
+
+// Square lattice of nodeCount nodes, four grid cells apart, with both
+// directions of every lattice edge and one airport per airportEvery nodes.
+static void buildLattice(int nodeCount, Graph& graph, int airportEvery = 50) {
+    BenchRandom rng(42);
+    int side = (int)ceil(sqrt((double)nodeCount));
+    for (int i = 0; i < nodeCount; i++) {
+        char name[20];
+        snprintf(name, sizeof(name), "N%d", i);
+        graph.addNode(name, (i % side) * 4, (i / side) * 4, i % airportEvery == 7);
+    }
+    for (int i = 0; i < nodeCount; i++) {
+        int right = i + 1, down = i + side;
+        if (i % side + 1 < side && right < nodeCount) {
+            graph.addEdge(i, right, 32 + rng.below(9));
+            graph.addEdge(right, i, 32 + rng.below(9));
+        }
+        if (down < nodeCount) {
+            graph.addEdge(i, down, 32 + rng.below(9));
+            graph.addEdge(down, i, 32 + rng.below(9));
+        }
+    }
+    graph.buildCSR();
+    graph.buildNearestAirportTable();
+}
+
+// n airborne flights on random lattice nodes, with route tables and tracks
+// already built by one tick.
+struct SimulationWorld {
+    unique_ptr<AircraftStore> store;
+    unique_ptr<HashTable> registry;
+    unique_ptr<MinHeap> queue;
+    unique_ptr<FlightLog> log;
+    unique_ptr<SimulationEngine> engine;
+
+    void build(const Graph& graph, const DynamicArray<FlightKey>& keys, int threads) {
+        engine.reset();
+        queue.reset();
+        log.reset();
+        registry.reset();
+        store.reset(new AircraftStore());
+        registry.reset(new HashTable(*store));
+        queue.reset(new MinHeap(*registry));
+        log.reset(new FlightLog(*store));
+        engine.reset(new SimulationEngine(graph, *registry, *queue, *log));
+        engine->setThreadCount(threads);
+
+        BenchRandom rng(8);
+        for (int i = 0; i < keys.getSize(); i++) {
+            Aircraft a = makeAircraft(keys[i].id, rng, 1, 1);
+            a.graphNode = rng.below(graph.getNodeCount());
+            a.gridX = graph.getNodeX(a.graphNode);
+            a.gridY = graph.getNodeY(a.graphNode);
+            a.fuelLevel = 100;
+            queue->insert(registry->insert(a));
+        }
+        engine->tick();
+    }
+};
+
+// ------------------------------------------------------------- benchmarks
+
+static void benchRegistry(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys, missing;
+    makeKeys(n, "PK", keys);
+    makeKeys(n, "ZZ", missing);
+    BenchRandom rng(1);
+    DynamicArray<Aircraft> flights;
+    for (int i = 0; i < n; i++) flights.pushBack(makeAircraft(keys[i].id, rng, 1000, 1000));
+
+    unique_ptr<AircraftStore> store;
+    unique_ptr<HashTable> table;
+    auto fresh = [&] {
+        table.reset();
+        store.reset(new AircraftStore());
+        table.reset(new HashTable(*store));
+    };
+    auto filled = [&] {
+        fresh();
+        for (int i = 0; i < n; i++) table->insert(flights[i]);
+    };
+
+    suite.measure("registry/insert", n, n, fresh, [&] {
+        for (int i = 0; i < n; i++) table->insert(flights[i]);
+    });
+    suite.measure("registry/search_hit", n, n, filled, [&] {
+        long long found = 0;
+        for (int i = 0; i < n; i++) found += table->findHandle(keys[i].id) != -1;
+        benchSink += found;
+    });
+    suite.measure("registry/search_miss", n, n, filled, [&] {
+        long long found = 0;
+        for (int i = 0; i < n; i++) found += table->findHandle(missing[i].id) != -1;
+        benchSink += found;
+    });
+    suite.measure("registry/remove", n, n, filled, [&] {
+        for (int i = 0; i < n; i++) table->remove(keys[i].id);
+    });
+    suite.measure("registry/find_occupant", n, n, filled, [&] {
+        long long hits = 0;
+        for (int i = 0; i < n; i++) hits += table->findOccupant(flights[i].gridX, flights[i].gridY) != -1;
+        benchSink += hits;
+    });
+    suite.measure("registry/update_position", n, n, filled, [&] {
+        for (int i = 0; i < n; i++) {
+            table->updatePosition(i, 0, (flights[i].gridX + 1) % 1000, flights[i].gridY);
+        }
+    });
+}
+
+static void benchLandingQueue(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+    BenchRandom rng(2);
+    AircraftStore store;
+    HashTable registry(store);
+    for (int i = 0; i < n; i++) registry.insert(makeAircraft(keys[i].id, rng, 1000, 1000));
+
+    unique_ptr<MinHeap> heap;
+    auto fresh = [&] {
+        // decreaseKey writes priorities back into the registry; restore them.
+        for (int i = 0; i < n; i++) store.priority(i) = 4;
+        heap.reset(new MinHeap(registry));
+    };
+    auto filled = [&] {
+        fresh();
+        for (int i = 0; i < n; i++) heap->insert(i);
+    };
+
+    suite.measure("heap/insert", n, n, fresh, [&] {
+        for (int i = 0; i < n; i++) heap->insert(i);
+    });
+    suite.measure("heap/extract_min", n, n, filled, [&] {
+        long long fuel = 0;
+        while (!heap->isEmpty()) fuel += heap->extractMin().fuelLevel;
+        benchSink += fuel;
+    });
+    suite.measure("heap/decrease_key", n, n, filled, [&] {
+        long long changed = 0;
+        for (int i = 0; i < n; i++) changed += heap->decreaseKey(keys[i].id, 1 + i % 3);
+        benchSink += changed;
+    });
+    // The O(n) strcmp lookups the position index replaced; a few hundred
+    // operations are enough.
+    const int scans = n < 256 ? n : 256;
+    suite.measure("heap/decrease_key_linear", n, scans, filled, [&] {
+        long long changed = 0;
+        for (int i = 0; i < scans; i++) changed += heap->decreaseKeyLinearScan(keys[i].id, 1 + i % 3);
+        benchSink += changed;
+    });
+    suite.measure("heap/remove", n, scans, filled, [&] {
+        long long removed = 0;
+        for (int i = 0; i < scans; i++) removed += heap->removeByFlightID(keys[i].id);
+        benchSink += removed;
+    });
+    suite.measure("heap/remove_linear", n, scans, filled, [&] {
+        long long removed = 0;
+        for (int i = 0; i < scans; i++) removed += heap->removeLinearScan(keys[i].id);
+        benchSink += removed;
+    });
+    suite.measure("heap/refresh_handle", n, n, filled, [&] {
+        for (int i = 0; i < n; i++) {
+            store.fuelLevel(i) = (store.fuelLevel(i) + 37) % 100;
+            heap->refreshHandle(i);
+        }
+    });
+    suite.measure("heap/rekey_all", n, n, filled, [&] {
+        heap->rekeyAll();
+    });
+}
+
+static void benchFlightLog(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+    BenchRandom rng(3);
+    DynamicArray<Aircraft> flights;
+    for (int i = 0; i < n; i++) flights.pushBack(makeAircraft(keys[i].id, rng, 1000, 1000));
+
+    unique_ptr<AircraftStore> store;
+    unique_ptr<FlightLog> log;
+    auto fresh = [&] {
+        log.reset();
+        store.reset(new AircraftStore());
+        log.reset(new FlightLog(*store));
+    };
+    auto filled = [&] {
+        fresh();
+        for (int i = 0; i < n; i++) log->insert(flights[i], "LANDED");
+    };
+
+    // insert takes the flights in random timestamp order; append is the
+    // usual case of clock-ordered events.
+    suite.measure("flightlog/insert", n, n, fresh, [&] {
+        for (int i = 0; i < n; i++) log->insert(flights[i], "LANDED");
+    });
+    suite.measure("flightlog/append", n, n, fresh, [&] {
+        for (int i = 0; i < n; i++) log->insert(1700000000 + i, keys[i].id, "AAA", "AAB", "LANDED");
+    });
+    suite.measure("flightlog/inorder_walk", n, n, filled, [&] {
+        SilenceCout quiet;
+        log->printLog();
+    });
+
+    const char* path = "skynet_bench_flightlog.tmp";
+    suite.measure("flightlog/save", n, n, filled, [&] {
+        log->saveToFile(path);
+    });
+    suite.measure("flightlog/load", n, n, fresh, [&] {
+        log->loadFromFile(path);
+    });
+    remove(path);
+
+    // Audit queries: 1000 random ten-second windows, pages of 50 and the
+    // last 100 entries, each against a log of n entries.
+    const int queries = 1000;
+    DynamicArray<int> starts;
+    for (int i = 0; i < queries; i++) starts.pushBack(flights[rng.below(n)].timestamp);
+    filled();
+    suite.measure("flightlog/count_range", n, queries, [] {}, [&] {
+        long long sum = 0;
+        for (int i = 0; i < queries; i++) sum += log->countRange(starts[i], starts[i] + 10);
+        benchSink += sum;
+    });
+    suite.measure("flightlog/range_scan", n, queries, [] {}, [&] {
+        long long sum = 0;
+        for (int i = 0; i < queries; i++) {
+            for (LogCursor c = log->range(starts[i], starts[i] + 10); c.isValid(); c.next()) {
+                sum += c.timestamp();
+            }
+        }
+        benchSink += sum;
+    });
+    suite.measure("flightlog/page_50", n, queries, [] {}, [&] {
+        long long sum = 0;
+        int pages = (n + 49) / 50;
+        for (int i = 0; i < queries; i++) {
+            for (LogCursor c = log->fromRank(rng.below(pages) * 50, 50); c.isValid(); c.next()) {
+                sum += c.timestamp();
+            }
+        }
+        benchSink += sum;
+    });
+    suite.measure("flightlog/last_100", n, queries, [] {}, [&] {
+        long long sum = 0;
+        for (int i = 0; i < queries; i++) {
+            for (LogCursor c = log->fromRank(n - 100, 100); c.isValid(); c.next()) {
+                sum += c.timestamp();
+            }
+        }
+        benchSink += sum;
+    });
+
+    // Per-flight trails: n events over n / 16 flights, then the full
+    // history of random flights through the index vs a scan of the log.
+    int flightCount = n / 16 > 0 ? n / 16 : 1;
+    fresh();
+    for (int i = 0; i < n; i++) {
+        log->insert(1700000000 + i, keys[rng.below(flightCount)].id, "AAA", "AAB", "LANDED");
+    }
+    DynamicArray<int> picks;
+    for (int i = 0; i < queries; i++) picks.pushBack(rng.below(flightCount));
+    suite.measure("flightlog/flight_history", n, queries, [] {}, [&] {
+        long long sum = 0;
+        for (int i = 0; i < queries; i++) {
+            for (HistoryCursor c = log->history(keys[picks[i]].id); c.isValid(); c.next()) {
+                sum += c.timestamp();
+            }
+        }
+        benchSink += sum;
+    });
+    const int scans = 10;
+    suite.measure("flightlog/flight_scan", n, scans, [] {}, [&] {
+        long long sum = 0;
+        for (int i = 0; i < scans; i++) {
+            const char* id = keys[picks[i]].id;
+            for (LogCursor c = log->fromRank(0, n); c.isValid(); c.next()) {
+                if (strcmp(c.flightID(), id) == 0) sum += c.timestamp();
+            }
+        }
+        benchSink += sum;
+    });
+}
+
+// Text parsing alone (tokenize and convert every field, nothing inserted)
+// over n flights and n log lines, then the full text loads.
+static void benchParse(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys;
+    makeKeys(2 * n, "PK", keys);
+    BenchRandom rng(5);
+
+    AircraftStore sourceStore;
+    HashTable sourceRegistry(sourceStore);
+    FlightLog sourceLog(sourceStore);
+    for (int i = 0; i < n; i++) {
+        sourceRegistry.insert(makeAircraft(keys[i].id, rng, 1000, 1000));
+        sourceLog.insert(makeAircraft(keys[n + i].id, rng, 1000, 1000), "LANDED");
+    }
+
+    const char* flightsPath = "skynet_bench_parse_flights.tmp";
+    const char* logPath = "skynet_bench_parse_log.tmp";
+    sourceRegistry.saveToFile(flightsPath);
+    sourceLog.saveToFile(logPath);
+    long long flightBytes = 0, logBytes = 0;
+    {
+        RecordReader probe;
+        if (probe.open(flightsPath)) flightBytes = (long long)probe.getSize();
+        if (probe.open(logPath)) logBytes = (long long)probe.getSize();
+    }
+
+    suite.measureBytes("parse/flights", n, n, flightBytes, [] {}, [&] {
+        RecordReader reader;
+        reader.open(flightsPath);
+        Aircraft a;
+        long long sum = 0;
+        while (reader.next()) {
+            HashTable::readRecord(reader, a);
+            sum += a.fuelLevel;
+        }
+        benchSink += sum;
+    });
+    suite.measureBytes("parse/flightlog", n, n, logBytes, [] {}, [&] {
+        RecordReader reader;
+        reader.open(logPath);
+        Aircraft a;
+        char status[20];
+        long long sum = 0;
+        while (reader.next()) {
+            FlightLog::readRecord(reader, a, status, sizeof(status));
+            sum += a.timestamp;
+        }
+        benchSink += sum;
+    });
+
+    unique_ptr<AircraftStore> store;
+    unique_ptr<HashTable> registry;
+    unique_ptr<FlightLog> log;
+    auto fresh = [&] {
+        log.reset();
+        registry.reset();
+        store.reset(new AircraftStore());
+        registry.reset(new HashTable(*store));
+        log.reset(new FlightLog(*store));
+    };
+    suite.measureBytes("parse/load_flights", n, n, flightBytes, fresh, [&] {
+        registry->loadFromFile(flightsPath);
+    });
+    suite.measureBytes("parse/load_flightlog", n, n, logBytes, fresh, [&] {
+        log->loadFromFile(logPath);
+    });
+    remove(flightsPath);
+    remove(logPath);
+}
+
+// Cold start of n flights plus n log entries: the binary snapshot against
+// the pipe-delimited text files holding the same state.
+static void benchSnapshot(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys;
+    makeKeys(2 * n, "PK", keys);
+    BenchRandom rng(4);
+
+    AircraftStore sourceStore;
+    HashTable sourceRegistry(sourceStore);
+    FlightLog sourceLog(sourceStore);
+    for (int i = 0; i < n; i++) {
+        sourceRegistry.insert(makeAircraft(keys[i].id, rng, 1000, 1000));
+        sourceLog.insert(makeAircraft(keys[n + i].id, rng, 1000, 1000), "LANDED");
+    }
+
+    const char* binaryPath = "skynet_bench_state.tmp";
+    const char* flightsPath = "skynet_bench_flights.tmp";
+    const char* logPath = "skynet_bench_log.tmp";
+    sourceRegistry.saveToFile(flightsPath);
+    sourceLog.saveToFile(logPath);
+
+    unique_ptr<AircraftStore> store;
+    unique_ptr<HashTable> registry;
+    unique_ptr<FlightLog> log;
+    auto fresh = [&] {
+        log.reset();
+        registry.reset();
+        store.reset(new AircraftStore());
+        registry.reset(new HashTable(*store));
+        log.reset(new FlightLog(*store));
+    };
+
+    suite.measure("snapshot/save_binary", n, n, [] {}, [&] {
+        saveSnapshot(binaryPath, sourceRegistry, sourceLog);
+    });
+    suite.measure("snapshot/load_binary", n, n, fresh, [&] {
+        loadSnapshot(binaryPath, *registry, *log);
+    });
+    suite.measure("snapshot/load_text", n, n, fresh, [&] {
+        registry->loadFromFile(flightsPath);
+        log->loadFromFile(logPath);
+    });
+    remove(binaryPath);
+    remove(flightsPath);
+    remove(logPath);
+}
+
+// Per-tick style sweeps over n records, in the old array-of-structs layout
+// (a plain Aircraft array) and in the store's columns. About 10% of the
+// aircraft are on the ground.
+static void benchAircraftScan(BenchSuite& suite, int n) {
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+    BenchRandom rng(9);
+    DynamicArray<Aircraft> records;
+    AircraftStore store;
+    for (int i = 0; i < n; i++) {
+        Aircraft a = makeAircraft(keys[i].id, rng, 1000, 1000);
+        a.inAir = rng.below(10) != 0;
+        records.pushBack(a);
+        store.allocate(a);
+    }
+    auto none = [] {};
+
+    suite.measure("scan/fuel_burn_aos", n, n, none, [&] {
+        for (int i = 0; i < n; i++) {
+            Aircraft& a = records[i];
+            if (!a.inAir) continue;
+            a.fuelLevel -= 1;
+            if (a.fuelLevel < 0) a.fuelLevel = 0;
+        }
+        benchSink += records[n - 1].fuelLevel;
+    });
+    suite.measure("scan/fuel_burn_soa", n, n, none, [&] {
+        int* fuel = store.fuelData();
+        const unsigned char* inAir = store.inAirData();
+        for (int i = 0; i < n; i++) {
+            int burned = fuel[i] - inAir[i];
+            fuel[i] = (burned < 0 && inAir[i]) ? 0 : burned;
+        }
+        benchSink += fuel[n - 1];
+    });
+
+    suite.measure("scan/airborne_positions_aos", n, n, none, [&] {
+        long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            const Aircraft& a = records[i];
+            if (a.inAir) sum += a.gridX + a.gridY;
+        }
+        benchSink += sum;
+    });
+    suite.measure("scan/airborne_positions_soa", n, n, none, [&] {
+        const int* xs = store.xData();
+        const int* ys = store.yData();
+        const unsigned char* inAir = store.inAirData();
+        long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += inAir[i] ? xs[i] + ys[i] : 0;
+        }
+        benchSink += sum;
+    });
+
+    suite.measure("scan/low_fuel_upgrade_aos", n, n, none, [&] {
+        int upgraded = 0;
+        for (int i = 0; i < n; i++) {
+            Aircraft& a = records[i];
+            if (a.inAir && a.fuelLevel < 10 && a.priority > 2) {
+                a.priority = 2;
+                upgraded++;
+            }
+        }
+        benchSink += upgraded;
+    });
+    suite.measure("scan/low_fuel_upgrade_soa", n, n, none, [&] {
+        const int* fuel = store.fuelData();
+        int* priority = store.priorityData();
+        const unsigned char* inAir = store.inAirData();
+        int upgraded = 0;
+        for (int i = 0; i < n; i++) {
+            bool upgrade = inAir[i] && fuel[i] < 10 && priority[i] > 2;
+            priority[i] = upgrade ? 2 : priority[i];
+            upgraded += upgrade;
+        }
+        benchSink += upgraded;
+    });
+}
+
+static void benchDynamicArray(BenchSuite& suite, int n) {
+    DynamicArray<int> values;
+    auto fresh = [&] { values = DynamicArray<int>(); };
+
+    suite.measure("dynarray/push_back", n, n, fresh, [&] {
+        for (int i = 0; i < n; i++) values.pushBack(i);
+        benchSink += values.getSize();
+    });
+    suite.measure("dynarray/push_back_reserved", n, n, [&] { fresh(); values.reserve(n); }, [&] {
+        for (int i = 0; i < n; i++) values.pushBack(i);
+        benchSink += values.getSize();
+    });
+}
+
+static void benchGraph(BenchSuite& suite, int n) {
+    Graph graph;
+    buildLattice(n, graph);
+    BenchRandom rng(4);
+
+    const int queries = 64;
+    DynamicArray<int> sources, targets;
+    for (int i = 0; i < queries; i++) {
+        sources.pushBack(rng.below(n));
+        targets.pushBack(rng.below(n));
+    }
+
+    DynamicArray<int> dist, parent, path;
+    auto none = [] {};
+
+    suite.measure("graph/dijkstra", n, queries, none, [&] {
+        for (int i = 0; i < queries; i++) graph.dijkstra(sources[i], dist, parent);
+        benchSink += dist[0];
+    });
+    // The O(V^2) reference implementation; a few queries are enough.
+    if (n <= 10000) {
+        const int scans = 4;
+        suite.measure("graph/dijkstra_linear_scan", n, scans, none, [&] {
+            for (int i = 0; i < scans; i++) graph.dijkstraLinearScan(sources[i], dist, parent);
+            benchSink += dist[0];
+        });
+    }
+    suite.measure("graph/nearest_airport_table", n, 1, none, [&] {
+        graph.buildNearestAirportTable();
+    });
+    suite.measure("graph/find_nearest_airport", n, n, none, [&] {
+        long long sum = 0;
+        for (int i = 0; i < n; i++) sum += graph.findNearestAirport(i, path);
+        benchSink += sum;
+    });
+
+    struct RouteBench {
+        const char* name;
+        RouteAlgorithm algorithm;
+    };
+    const RouteBench routes[] = {
+        { "graph/route_dijkstra", ROUTE_DIJKSTRA },
+        { "graph/route_astar", ROUTE_ASTAR },
+        { "graph/route_bidirectional", ROUTE_BIDIRECTIONAL }
+    };
+    // Nodes expanded per query are reported next to the time, since the
+    // point of A* and bidirectional search is to settle fewer of them.
+    for (const RouteBench& route : routes) {
+        long long expandedTotal = 0;
+        suite.measure(route.name, n, queries, [&] { expandedTotal = 0; }, [&] {
+            long long cost = 0;
+            for (int i = 0; i < queries; i++) {
+                int expanded = 0;
+                cost += graph.findRoute(sources[i], targets[i], path, route.algorithm, &expanded);
+                expandedTotal += expanded;
+            }
+            benchSink += cost;
+        });
+        suite.annotate(route.name, "expanded_per_query", (double)expandedTotal / queries);
+    }
+}
+
+static void benchSpatial(BenchSuite& suite, int n) {
+    BenchRandom rng(5);
+    int side = (int)ceil(sqrt((double)n)) * 2;
+    DynamicArray<int> xs, ys;
+    for (int i = 0; i < n; i++) {
+        xs.pushBack(rng.below(side));
+        ys.pushBack(rng.below(side));
+    }
+
+    SpatialIndex index;
+    auto filled = [&] {
+        index.clear();
+        for (int i = 0; i < n; i++) index.insert(i, xs[i], ys[i]);
+    };
+
+    suite.measure("spatial/insert", n, n, [&] { index.clear(); }, [&] {
+        for (int i = 0; i < n; i++) index.insert(i, xs[i], ys[i]);
+    });
+    suite.measure("spatial/move", n, n, filled, [&] {
+        for (int i = 0; i < n; i++) index.move(i, ys[i], xs[i]);
+    });
+    suite.measure("spatial/find_at", n, n, filled, [&] {
+        long long hits = 0;
+        for (int i = 0; i < n; i++) hits += index.findAt(ys[i], xs[i]) != -1;
+        benchSink += hits;
+    });
+}
+
+static void benchConflicts(BenchSuite& suite, int n) {
+    BenchRandom rng(6);
+    int side = (int)ceil(sqrt((double)n)) * 3;
+    AircraftStore store;
+    HashTable registry(store);
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+    for (int i = 0; i < n; i++) registry.insert(makeAircraft(keys[i].id, rng, side, side));
+
+    ConflictDetector detector;
+    DynamicArray<ConflictPair> pairs;
+    auto none = [] {};
+
+    suite.measure("conflicts/rebuild", n, n, none, [&] {
+        detector.rebuild(registry, MIN_SEPARATION);
+    });
+    suite.measure("conflicts/grid_sweep", n, n, [&] { detector.rebuild(registry, MIN_SEPARATION); }, [&] {
+        detector.findConflicts(MIN_SEPARATION, pairs);
+        benchSink += pairs.getSize();
+    });
+
+    // The O(n^2) comparison the grid replaced, for reference.
+    if (n <= 10000) {
+        suite.measure("conflicts/brute_force", n, n, none, [&] {
+            long long found = 0;
+            const int limit = MIN_SEPARATION * MIN_SEPARATION;
+            const int* xs = store.xData();
+            const int* ys = store.yData();
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    int dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+                    found += dx * dx + dy * dy <= limit;
+                }
+            }
+            benchSink += found;
+        });
+    }
+}
+
+static void benchRadar(BenchSuite& suite, int n) {
+    // Sized so that the aircraft cover about a quarter of the radar.
+    Graph graph;
+    int side = (int)ceil(sqrt((double)n) * 2);
+    graph.addNode("AAA", 0, 0, true);
+    graph.addNode("AAB", side - 1, side - 1, true);
+
+    BenchRandom rng(7);
+    DynamicArray<Aircraft> flights;
+    for (int i = 0; i < n; i++) {
+        char id[20];
+        snprintf(id, sizeof(id), "PK%d", i);
+        flights.pushBack(makeAircraft(id, rng, side, side));
+    }
+
+    Radar radar;
+    radar.initialize(graph);
+    auto none = [] {};
+    string frame;
+    int cells = side * side;
+
+    suite.measure("radar/place_planes", n, n, none, [&] {
+        radar.placePlanes(flights);
+    });
+    suite.measure("radar/render_frame", cells, cells, [&] { radar.placePlanes(flights); }, [&] {
+        radar.renderFrame(frame);
+        benchSink += (long long)frame.size();
+    });
+    suite.measure("radar/display", cells, cells, [&] { radar.placePlanes(flights); }, [&] {
+        SilenceCout quiet;
+        radar.display();
+    });
+}
+
+// One row per pool size, so the parallel advance pass shows its scaling.
+static void benchSimulation(BenchSuite& suite, int n, const DynamicArray<int>& threadCounts) {
+    const int ticks = 10;
+    int nodes = n / 10 > 400 ? n / 10 : 400;
+
+    Graph graph;
+    buildLattice(nodes, graph);
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+
+    SimulationWorld world;
+    int threads = 1;
+    for (int i = 0; i < threadCounts.getSize(); i++) {
+        threads = threadCounts[i];
+        string name = "simulation/tick_threads_" + to_string(threads);
+        suite.measure(name.c_str(), n, (long long)n * ticks, [&] { world.build(graph, keys, threads); }, [&] {
+            for (int t = 0; t < ticks; t++) benchSink += world.engine->tick().arrivals;
+        });
+    }
+}
+
+// Cost of the latency hooks against the 2% budget. The hook rows time the
+// ScopedLatency that METRIC_TIMER expands to on its own: sampled, as the
+// fast operations use it, and on every call, as the tick uses it. Each
+// operation row is annotated with that cost as a share of the operation
+// without it. A build with -DSKYNET_METRICS=OFF runs the same rows with the
+// hooks compiled out, for a direct comparison.
+static void benchMetrics(BenchSuite& suite, int n) {
+    suite.measure("metrics/hook_sampled", n, n, [] {}, [&] {
+        for (int i = 0; i < n; i++) {
+            ScopedLatency timer(OP_ADD_FLIGHT);
+        }
+    });
+    suite.measure("metrics/hook_every_call", n, n, [] {}, [&] {
+        for (int i = 0; i < n; i++) {
+            ScopedLatency timer(OP_SIMULATION_TICK);
+        }
+    });
+    double sampledHook = suite.bestNsPerOp("metrics/hook_sampled");
+    double everyCallHook = suite.bestNsPerOp("metrics/hook_every_call");
+    auto overhead = [&](const char* name, double hook) {
+        double op = suite.bestNsPerOp(name);
+        if (Metrics::isEnabled()) op -= hook;
+        if (hook > 0.0 && op > 0.0) suite.annotate(name, "hook_overhead_pct", hook / op * 100.0);
+    };
+
+    // One flight per node, with as many free nodes to move to.
+    const char* airspacePath = "skynet_bench_airspace.tmp";
+    {
+        Graph graph;
+        buildLattice(2 * n, graph);
+        graph.saveToFile(airspacePath);
+    }
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+
+    unique_ptr<ATCSystem> atc;
+    auto empty = [&] {
+        atc.reset();
+        atc.reset(new ATCSystem(airspacePath));
+    };
+    auto populated = [&] {
+        empty();
+        BenchRandom rng(12);
+        for (int i = 0; i < n; i++) atc->spawnFlight(makeAircraft(keys[i].id, rng, 1, 1), i);
+    };
+
+    suite.measure("metrics/add_flight", n, n, empty, [&] {
+        BenchRandom rng(12);
+        for (int i = 0; i < n; i++) atc->spawnFlight(makeAircraft(keys[i].id, rng, 1, 1), i);
+    });
+    overhead("metrics/add_flight", sampledHook);
+    suite.measure("metrics/move_flight", n, n, populated, [&] {
+        for (int i = 0; i < n; i++) atc->relocateFlight(keys[i].id, n + i);
+    });
+    overhead("metrics/move_flight", sampledHook);
+    suite.measure("metrics/declare_emergency", n, n, populated, [&] {
+        long long changed = 0;
+        for (int i = 0; i < n; i++) changed += atc->applyEmergency(keys[i].id, 1 + i % 4);
+        benchSink += changed;
+    });
+    overhead("metrics/declare_emergency", sampledHook);
+    suite.measure("metrics/land_flight", n, n, populated, [&] {
+        for (int i = 0; i < n; i++) benchSink += atc->landNextFlight().fuelLevel;
+    });
+    overhead("metrics/land_flight", sampledHook);
+    atc.reset();
+    remove(airspacePath);
+
+    // The tick runs on a sparser lattice, as in benchSimulation: route
+    // tables for two nodes per flight do not fit in memory at large n.
+    Graph graph;
+    buildLattice(n / 10 > 400 ? n / 10 : 400, graph);
+    SimulationWorld world;
+    const int ticks = 10;
+    suite.measure("metrics/simulation_tick", n, ticks, [&] { world.build(graph, keys, 1); }, [&] {
+        for (int t = 0; t < ticks; t++) benchSink += world.engine->tick().arrivals;
+    });
+    overhead("metrics/simulation_tick", everyCallHook);
+    metrics().reset();
+}
+
+static bool fileExists(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    fclose(file);
+    return true;
+}
+
+// The whole system at scale, through ATCSystem: spawning n flights, ticking
+// them, saving a snapshot and loading it into a fresh system. The airspace
+// has one node per flight and about eight airports, which keeps the
+// per-airport route tables small at 1M. ATCSystem keeps its state in
+// state.bin and journal.txt in the working directory, so the group is
+// skipped rather than overwrite existing ones.
+static void benchSystem(BenchSuite& suite, int n) {
+    if (!suite.enabled("system/spawn") && !suite.enabled("system/tick")
+        && !suite.enabled("system/save") && !suite.enabled("system/load")) {
+        return;
+    }
+    if (fileExists("state.bin") || fileExists("journal.txt")) {
+        cerr << "Skipping system/ benchmarks: state.bin or journal.txt exists in the working directory" << endl;
+        return;
+    }
+
+    const char* airspacePath = "skynet_bench_system_airspace.tmp";
+    {
+        Graph graph;
+        buildLattice(n, graph, n / 8 > 50 ? n / 8 : 50);
+        graph.saveToFile(airspacePath);
+    }
+    DynamicArray<FlightKey> keys;
+    makeKeys(n, "PK", keys);
+
+    unique_ptr<ATCSystem> atc;
+    auto empty = [&] {
+        atc.reset();
+        atc.reset(new ATCSystem(airspacePath));
+    };
+    auto spawnAll = [&] {
+        BenchRandom rng(13);
+        for (int i = 0; i < n; i++) atc->spawnFlight(makeAircraft(keys[i].id, rng, 1, 1), i);
+    };
+    auto populated = [&] {
+        empty();
+        spawnAll();
+        atc->runSimulationTick();   // builds route tables and tracks
+    };
+
+    const int ticks = 10;
+    suite.measure("system/spawn", n, n, empty, spawnAll);
+    suite.measure("system/tick", n, (long long)n * ticks, populated, [&] {
+        for (int t = 0; t < ticks; t++) benchSink += atc->runSimulationTick().arrivals;
+    });
+    suite.measure("system/save", n, n, populated, [&] {
+        atc->writeState();
+    });
+    if (suite.enabled("system/load")) {
+        populated();
+        atc->writeState();
+        suite.measure("system/load", n, n, empty, [&] {
+            atc->readState();
+        });
+    }
+
+    atc.reset();
+    remove(airspacePath);
+    remove("state.bin");
+    remove("journal.txt");
+}
+
+// ------------------------------------------------------------------ driver
+
+static bool parseSizes(const char* text, DynamicArray<int>& sizes) {
+    sizes.clear();
+    const char* p = text;
+    while (*p) {
+        char* end = nullptr;
+        long value = strtol(p, &end, 10);
+        if (end == p || value < 1 || value > 100000000) return false;
+        sizes.pushBack((int)value);
+        p = end;
+        if (*p == ',') p++;
+        else if (*p != '\0') return false;
+    }
+    return !sizes.isEmpty();
+}
+
+int main(int argc, char* argv[]) {
+    DynamicArray<int> sizes;
+    sizes.pushBack(1000);
+    sizes.pushBack(10000);
+    sizes.pushBack(100000);
+    DynamicArray<int> systemSizes;
+    systemSizes.pushBack(10000);
+    systemSizes.pushBack(100000);
+    systemSizes.pushBack(1000000);
+    DynamicArray<int> threadCounts;
+    int cores = (int)thread::hardware_concurrency();
+    const int defaultThreads[] = { 1, 2, 4, cores };
+    for (int count : defaultThreads) {
+        bool seen = count < 1;
+        for (int i = 0; i < threadCounts.getSize(); i++) seen = seen || threadCounts[i] == count;
+        if (!seen) threadCounts.pushBack(count);
+    }
+    int repeats = 5;
+    string filter;
+    const char* outPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--sizes") == 0 && hasValue && parseSizes(argv[i + 1], sizes)) i++;
+        else if (strcmp(argv[i], "--system-sizes") == 0 && hasValue && parseSizes(argv[i + 1], systemSizes)) i++;
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue && parseSizes(argv[i + 1], threadCounts)) i++;
+        else if (strcmp(argv[i], "--repeat") == 0 && hasValue && atoi(argv[i + 1]) > 0) repeats = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && hasValue) filter = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && hasValue) outPath = argv[++i];
+        else {
+            cerr << "Usage: " << argv[0]
+                << " [--sizes 1000,10000,100000] [--system-sizes 10000,100000,1000000]"
+                << " [--threads 1,2,4] [--repeat n] [--filter text] [--out file]" << endl;
+            return 1;
+        }
+    }
+
+    BenchSuite suite(filter, repeats);
+    try {
+        for (int i = 0; i < sizes.getSize(); i++) {
+            int n = sizes[i];
+            benchRegistry(suite, n);
+            benchLandingQueue(suite, n);
+            benchFlightLog(suite, n);
+            benchSnapshot(suite, n);
+            benchParse(suite, n);
+            benchAircraftScan(suite, n);
+            benchDynamicArray(suite, n);
+            benchGraph(suite, n);
+            benchSpatial(suite, n);
+            benchConflicts(suite, n);
+            benchRadar(suite, n);
+            benchSimulation(suite, n, threadCounts);
+            benchMetrics(suite, n);
+        }
+        for (int i = 0; i < systemSizes.getSize(); i++) {
+            benchSystem(suite, systemSizes[i]);
+        }
+    }
+    catch (const ATCException& e) {
+        cerr << "Benchmark failed: " << e.what() << endl;
+        return 1;
+    }
+
+    if (outPath != nullptr) {
+        ofstream out(outPath);
+        if (!out.is_open()) {
+            cerr << "Cannot write " << outPath << endl;
+            return 1;
+        }
+        suite.writeJson(out);
+    }
+    else {
+        suite.writeJson(cout);
+    }
+    return 0;
+}
@@ -2,15 +2,91 @@
 #include "Exceptions.h"
 #include "Utilities.h"
 #include "Colors.h"
+#include "ScriptRunner.h"
+#include "Metrics.h"
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
 
 using namespace std;
 
-int main() {
+// --script <file|-> runs commands headlessly instead of showing the menu;
+// --quiet keeps only errors and the final summary; --threads sets the
+// simulation thread count (default: one per core). --airspace loads the
+// graph from a file instead of the built-in demo airspace.
+static int runScript(const char* scriptPath, const char* airspacePath, bool quiet, int threads) {
+    ATCSystem atc(airspacePath);
+    atc.setSimulationThreads(threads);
+    ScriptRunner runner(atc, quiet);
+
+    if (strcmp(scriptPath, "-") == 0) {
+        runner.run(cin);
+    }
+    else {
+        ifstream script(scriptPath);
+        if (!script) {
+            throw FileException(scriptPath);
+        }
+        runner.run(script);
+    }
+
+    runner.printSummary(cout);
+    return runner.getFailedCount() == 0 ? 0 : 2;
+}
+
+// --metrics-out writes the latency histograms and counters in Prometheus
+// format when the program exits normally.
+static void writeMetrics(const char* metricsPath) {
+    if (metricsPath == nullptr) return;
+
+    ofstream file(metricsPath);
+    if (!file.is_open()) {
+        throw FileException(metricsPath);
+    }
+    metrics().writePrometheus(file);
+}
+
+int main(int argc, char* argv[]) {
+    const char* scriptPath = nullptr;
+    const char* airspacePath = nullptr;
+    const char* metricsPath = nullptr;
+    bool quiet = false;
+    int threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            scriptPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--airspace") == 0 && i + 1 < argc) {
+            airspacePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--metrics-out") == 0 && i + 1 < argc) {
+            metricsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else {
+            cerr << "Usage: " << argv[0] << " [--script <file|->] [--airspace <file>] [--metrics-out <file>] [--quiet] [--threads <n>]" << endl;
+            return 1;
+        }
+    }
+
     try {
+        if (scriptPath != nullptr) {
+            int status = runScript(scriptPath, airspacePath, quiet, threads);
+            writeMetrics(metricsPath);
+            return status;
+        }
+
+        enableAnsiColors();
         setColor(15);
-        ATCSystem atc;
+        ATCSystem atc(airspacePath);
         atc.run();
+        writeMetrics(metricsPath);
     }
     catch (const ATCException& e) {
         setColor(12); 
@@ -34,5 +110,9 @@ int main() {
         return 1;
     }
 
+#ifdef _WIN32
     return system("pause");
+#else
+    return 0;
+#endif
 }
@@ -0,0 +1,311 @@
+// Synthetic airspace and traffic generator for load testing.
+//
+// Writes <out>/airspace.txt (Graph::loadFromFile format), <out>/flights.txt
+// (HashTable::loadFromFile format) and <out>/flightlog.txt
+// (FlightLog::loadFromFile format). With --format binary or both it also
+// writes <out>/state.bin (Snapshot.h). The files are produced through the
+// same save routines the ATC system uses, so they always round-trip. The
+// same seed and options always give byte-identical output.
+//
+// Usage:
+//   TrafficGenerator [--seed n] [--aircraft n] [--log n] [--waypoints n]
+//                    [--airports n] [--spacing n] [--fuel min-max]
+//                    [--priority w1,w2,w3,w4] [--landed percent]
+//                    [--format text|binary|both] [--out dir]
+
+#include "../Graph.h"
+#include "../HashTable.h"
+#include "../FlightLog.h"
+#include "../Exceptions.h"
+#include "../Snapshot.h"
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+// splitmix64: tiny, fast and identical on every platform, unlike the
+// standard library distributions.
+class SeededRandom {
+private:
+    unsigned long long state;
+
+public:
+    explicit SeededRandom(unsigned long long seed) : state(seed) {}
+
+    unsigned long long next() {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound).
+    int below(int bound) {
+        return bound <= 0 ? 0 : (int)(next() % (unsigned long long)bound);
+    }
+
+    int between(int low, int high) {
+        return low + below(high - low + 1);
+    }
+};
+
+struct GeneratorOptions {
+    unsigned long long seed;
+    int aircraft;
+    int logEntries;
+    int waypoints;
+    int airports;
+    int spacing;
+    int fuelMin, fuelMax;
+    int priorityWeights[4];
+    int landedPercent;
+    bool writeText, writeBinary;
+    string outDir;
+};
+
+static const char* AIRLINES[] = { "PK", "EK", "BA", "AA", "QR", "LH", "AF", "DL", "UA", "TK", "SQ", "EY" };
+static const char* MODELS[] = { "A320", "A321", "A330", "A350", "A380", "B737", "B747", "B777", "B787", "E190", "ATR72", "CRJ900" };
+static const int AIRLINE_COUNT = sizeof(AIRLINES) / sizeof(AIRLINES[0]);
+static const int MODEL_COUNT = sizeof(MODELS) / sizeof(MODELS[0]);
+static const int BASE_TIMESTAMP = 1700000000;
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [--seed n] [--aircraft n] [--log n] [--waypoints n]\n"
+        << "       [--airports n] [--spacing n] [--fuel min-max] [--priority w1,w2,w3,w4]\n"
+        << "       [--landed percent] [--format text|binary|both] [--out dir]" << endl;
+}
+
+static bool parseOptions(int argc, char* argv[], GeneratorOptions& opt) {
+    opt.seed = 1;
+    opt.aircraft = 1000;
+    opt.logEntries = -1;
+    opt.waypoints = 500;
+    opt.airports = 20;
+    opt.spacing = 5;
+    opt.fuelMin = 5;
+    opt.fuelMax = 100;
+    opt.priorityWeights[0] = 5;
+    opt.priorityWeights[1] = 10;
+    opt.priorityWeights[2] = 35;
+    opt.priorityWeights[3] = 50;
+    opt.landedPercent = 0;
+    opt.writeText = true;
+    opt.writeBinary = false;
+    opt.outDir = ".";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) return false;
+        i++;
+
+        if (strcmp(arg, "--seed") == 0) opt.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--aircraft") == 0) opt.aircraft = atoi(value);
+        else if (strcmp(arg, "--log") == 0) opt.logEntries = atoi(value);
+        else if (strcmp(arg, "--waypoints") == 0) opt.waypoints = atoi(value);
+        else if (strcmp(arg, "--airports") == 0) opt.airports = atoi(value);
+        else if (strcmp(arg, "--spacing") == 0) opt.spacing = atoi(value);
+        else if (strcmp(arg, "--landed") == 0) opt.landedPercent = atoi(value);
+        else if (strcmp(arg, "--out") == 0) opt.outDir = value;
+        else if (strcmp(arg, "--format") == 0) {
+            opt.writeText = strcmp(value, "binary") != 0;
+            opt.writeBinary = strcmp(value, "text") != 0;
+            if (strcmp(value, "text") != 0 && strcmp(value, "binary") != 0
+                && strcmp(value, "both") != 0) return false;
+        }
+        else if (strcmp(arg, "--fuel") == 0) {
+            if (sscanf(value, "%d-%d", &opt.fuelMin, &opt.fuelMax) != 2) return false;
+        }
+        else if (strcmp(arg, "--priority") == 0) {
+            int* w = opt.priorityWeights;
+            if (sscanf(value, "%d,%d,%d,%d", &w[0], &w[1], &w[2], &w[3]) != 4) return false;
+        }
+        else return false;
+    }
+
+    if (opt.logEntries < 0) opt.logEntries = opt.aircraft;
+    int weightSum = opt.priorityWeights[0] + opt.priorityWeights[1]
+        + opt.priorityWeights[2] + opt.priorityWeights[3];
+
+    return opt.aircraft >= 0 && opt.waypoints >= 0 && opt.airports >= 2
+        && opt.spacing >= 1 && opt.fuelMin >= 0 && opt.fuelMax <= 100
+        && opt.fuelMin <= opt.fuelMax && weightSum > 0
+        && opt.priorityWeights[0] >= 0 && opt.priorityWeights[1] >= 0
+        && opt.priorityWeights[2] >= 0 && opt.priorityWeights[3] >= 0
+        && opt.landedPercent >= 0 && opt.landedPercent <= 100;
+}
+
+// Three-letter code for airport i (AAA, AAB, ...), then AP<n> past ZZZ.
+static void airportName(int i, char* name, int size) {
+    if (i < 26 * 26 * 26) {
+        snprintf(name, size, "%c%c%c", 'A' + i / 676, 'A' + (i / 26) % 26, 'A' + i % 26);
+    }
+    else {
+        snprintf(name, size, "AP%d", i);
+    }
+}
+
+// Edge cost: straight-line length scaled to the demo airspace's units
+// (about 8 per grid cell) plus up to 25% headwind, so the two directions of
+// a leg usually differ.
+static int legWeight(const Graph& graph, int a, int b, SeededRandom& rng) {
+    double dx = graph.getNodeX(a) - graph.getNodeX(b);
+    double dy = graph.getNodeY(a) - graph.getNodeY(b);
+    double base = sqrt(dx * dx + dy * dy) * 8.0;
+    int weight = (int)(base * (100 + rng.below(26)) / 100.0 + 0.5);
+    return weight < 1 ? 1 : weight;
+}
+
+// Nodes sit on a jittered lattice, one per spacing x spacing square, so
+// positions never collide. Lattice neighbours are always linked (the graph is
+// connected) and about a third of the diagonals add shortcuts. Airports are
+// spread at random over the lattice.
+static void buildAirspace(const GeneratorOptions& opt, SeededRandom& rng, Graph& graph,
+    DynamicArray<int>& airports) {
+    int total = opt.waypoints + opt.airports;
+    int cols = (int)ceil(sqrt((double)total));
+    int rows = (total + cols - 1) / cols;
+
+    DynamicArray<bool> isAirport;
+    isAirport.resize(total, false);
+    DynamicArray<int> order;
+    for (int i = 0; i < total; i++) order.pushBack(i);
+    for (int i = 0; i < opt.airports; i++) {
+        int j = i + rng.below(total - i);
+        int t = order[i]; order[i] = order[j]; order[j] = t;
+        isAirport[order[i]] = true;
+    }
+
+    int airportCount = 0, waypointCount = 0;
+    for (int i = 0; i < total; i++) {
+        char name[20];
+        if (isAirport[i]) airportName(airportCount++, name, sizeof(name));
+        else snprintf(name, sizeof(name), "WP%d", ++waypointCount);
+
+        int x = (i % cols) * opt.spacing + rng.below(opt.spacing);
+        int y = (i / cols) * opt.spacing + rng.below(opt.spacing);
+        int node = graph.addNode(name, x, y, isAirport[i]);
+        if (isAirport[i]) airports.pushBack(node);
+    }
+
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            if (u >= total) break;
+
+            int neighbours[3] = { -1, -1, -1 };
+            if (c + 1 < cols && u + 1 < total) neighbours[0] = u + 1;
+            if (u + cols < total) neighbours[1] = u + cols;
+            if (c + 1 < cols && u + cols + 1 < total && rng.below(3) == 0) neighbours[2] = u + cols + 1;
+
+            for (int k = 0; k < 3; k++) {
+                int v = neighbours[k];
+                if (v == -1) continue;
+                graph.addEdge(u, v, legWeight(graph, u, v, rng));
+                graph.addEdge(v, u, legWeight(graph, v, u, rng));
+            }
+        }
+    }
+}
+
+static int pickPriority(const GeneratorOptions& opt, SeededRandom& rng) {
+    const int* w = opt.priorityWeights;
+    int roll = rng.below(w[0] + w[1] + w[2] + w[3]);
+    for (int p = 0; p < 4; p++) {
+        if (roll < w[p]) return p + 1;
+        roll -= w[p];
+    }
+    return 4;
+}
+
+static void pickRoute(const Graph& graph, const DynamicArray<int>& airports, SeededRandom& rng, Aircraft& a) {
+    int from = rng.below(airports.getSize());
+    int to = rng.below(airports.getSize() - 1);
+    if (to >= from) to++;
+    a.setOrigin(graph.getNodeName(airports[from]));
+    a.setDestination(graph.getNodeName(airports[to]));
+}
+
+static void flightID(int serial, SeededRandom& rng, char* id, int size) {
+    snprintf(id, size, "%s%d", AIRLINES[rng.below(AIRLINE_COUNT)], 100 + serial);
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        SeededRandom rng(opt.seed);
+
+        Graph graph;
+        DynamicArray<int> airports;
+        buildAirspace(opt, rng, graph, airports);
+
+        // Active traffic: spread over every node, timestamps in the last
+        // three hours.
+        AircraftStore store;
+        HashTable registry(store);
+        for (int i = 0; i < opt.aircraft; i++) {
+            Aircraft a;
+            char id[20];
+            flightID(i, rng, id, sizeof(id));
+            a.setFlightID(id);
+            a.setModel(MODELS[rng.below(MODEL_COUNT)]);
+            a.fuelLevel = rng.between(opt.fuelMin, opt.fuelMax);
+            pickRoute(graph, airports, rng, a);
+            a.priority = pickPriority(opt, rng);
+            a.graphNode = rng.below(graph.getNodeCount());
+            a.gridX = graph.getNodeX(a.graphNode);
+            a.gridY = graph.getNodeY(a.graphNode);
+            a.inAir = rng.below(100) >= opt.landedPercent;
+            a.timestamp = BASE_TIMESTAMP - rng.below(3 * 3600);
+            registry.insert(a);
+        }
+
+        // History: earlier landings over the preceding 30 days, with serials
+        // that do not clash with the active flights.
+        FlightLog flightLog(store);
+        for (int i = 0; i < opt.logEntries; i++) {
+            Aircraft a;
+            char id[20];
+            flightID(opt.aircraft + i, rng, id, sizeof(id));
+            a.setFlightID(id);
+            pickRoute(graph, airports, rng, a);
+            a.timestamp = BASE_TIMESTAMP - 3 * 3600 - rng.below(30 * 24 * 3600);
+            flightLog.insert(a, "LANDED");
+        }
+
+        string airspacePath = opt.outDir + "/airspace.txt";
+        string flightsPath = opt.outDir + "/flights.txt";
+        string logPath = opt.outDir + "/flightlog.txt";
+        string snapshotPath = opt.outDir + "/state.bin";
+        graph.saveToFile(airspacePath.c_str());
+        cout << "Wrote " << airspacePath << " (" << graph.getNodeCount() << " nodes, "
+            << graph.getEdgeCount() << " edges, " << airports.getSize() << " airports)\n";
+
+        if (opt.writeText) {
+            registry.saveToFile(flightsPath.c_str());
+            flightLog.saveToFile(logPath.c_str());
+            cout << "Wrote " << flightsPath << " (" << registry.getCount() << " flights)\n"
+                << "Wrote " << logPath << " (" << opt.logEntries << " log entries)\n";
+        }
+        if (opt.writeBinary) {
+            saveSnapshot(snapshotPath.c_str(), registry, flightLog);
+            cout << "Wrote " << snapshotPath << " (" << registry.getCount() << " flights, "
+                << opt.logEntries << " log entries)\n";
+        }
+        cout << flush;
+    }
+    catch (const ATCException& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}